@@ -0,0 +1,398 @@
+/***********************************************************************************************************
+
+  Animation encoder for WS28XX_ANIMATION, and a host check of its decoder.
+
+    anim RAW PIXEL OUT [KEY] [FPS]  encode raw RGB frames, 3 bytes per pixel, red first, PIXEL pixels each,
+                                    with a keyframe at least every KEY frames (default 60, 0 for the first only)
+    anim                            encode a generated animation, written nowhere
+
+  Each frame is a keyframe or the spans of pixels that differ from the frame before, whichever is smaller,
+  as runs of one color or of literal colors. The format is described at WS28XX_ANIM_MAGIC in ws28xx.h. Every
+  animation is decoded again with WS28XX_Animation_Next and each frame compared with the raw one stored by
+  WS28XX_CopyPixel_RGB_888, then the compression ratio and the decode time are reported.
+
+***********************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ws28xx.h"
+
+/************************************************************************************************************
+**************    Private Definitions
+************************************************************************************************************/
+
+#define ANIM_MIN_NS    20000000ULL
+#define ANIM_REPEAT    5
+#define ANIM_TIMER_MHZ 72
+#define ANIM_KEY       60  //@info Default keyframe interval
+#define ANIM_FPS       30  //@info Default frame rate of the header
+#define ANIM_GAP       1   //@info Unchanged pixels a span bridges, 3 bytes each against 5 for a new span and run
+#define ANIM_RUN_MAX   128 //@info Pixels of one run byte
+#define ANIM_FRAME     240 //@info Frames of the generated animation
+
+//@info Worst case bytes of one frame of Pixel pixels, a keyframe of literal runs
+#define ANIM_FRAME_BYTES(Pixel) (2 + 4 + ((size_t)(Pixel) * 3) + (((size_t)(Pixel) + ANIM_RUN_MAX - 1) / ANIM_RUN_MAX))
+
+typedef void (*ANIM_FuncTypeDef)(void);
+
+/************************************************************************************************************
+**************    Private Variables
+************************************************************************************************************/
+
+static WS28XX_HandleTypeDef hLed;
+static TIM_TypeDef          hTimInstance;
+static TIM_HandleTypeDef    hTim;
+static DMA_HandleTypeDef    hDma = {.Init.Mode             = DMA_NORMAL,
+                                    .Init.MemInc           = DMA_MINC_ENABLE,
+                                    .Init.MemDataAlignment = (WS28XX_BYTE_PULSE == true) ? DMA_MDATAALIGN_BYTE : DMA_MDATAALIGN_HALFWORD,
+                                    .Parent                = &hTim};
+static TIM_HandleTypeDef    hTim = {.Instance = &hTimInstance, .hdma[TIM_DMA_ID_CC1] = &hDma};
+static WS28XX_PixelTypeDef  ANIM_Saved[WS28XX_PIXEL_MAX];
+
+static const uint8_t *ANIM_Raw;      //@info Raw frames of the timings
+static uint16_t       ANIM_Pixel;
+static uint16_t       ANIM_Frame;
+static uint64_t       ANIM_Dirty;    //@info Pixels WS28XX_Update encoded over one pass of ANIM_Next_Update
+
+/************************************************************************************************************
+**************    Private Functions
+************************************************************************************************************/
+
+void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PulseFinishedCallback(&hLed, htim);
+}
+
+/***********************************************************************************************************/
+
+static uint64_t ANIM_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/***********************************************************************************************************/
+
+static uint8_t *ANIM_Put16(uint8_t *Out, uint16_t Value) {
+	Out[0] = (uint8_t)Value;
+	Out[1] = (uint8_t)(Value >> 8);
+	return Out + 2;
+}
+
+/***********************************************************************************************************/
+
+//@info Span of Count pixels of the frame Rgb from First on, as runs of one color where at least two pixels are
+//      equal and literal runs in between
+static uint8_t *ANIM_EncodeSpan(uint8_t *Out, const uint8_t *Rgb, uint16_t First, uint16_t Count) {
+	const uint8_t *px   = &Rgb[(size_t)First * 3];
+	uint32_t       left = Count;
+	Out                 = ANIM_Put16(Out, First);
+	Out                 = ANIM_Put16(Out, Count);
+	while (left > 0) {
+		uint32_t n = 1;
+		while ((n < left) && (n < ANIM_RUN_MAX) && (memcmp(px, &px[n * 3], 3) == 0)) {
+			n++;
+		}
+		if (n >= 2) {
+			*Out++ = (uint8_t)(WS28XX_ANIM_RUN | (n - 1));
+			memcpy(Out, px, 3);
+			Out += 3;
+		} else {
+			//@info literal colors up to where two equal ones start a run
+			while ((n < left) && (n < ANIM_RUN_MAX) && !(((n + 1) < left) && (memcmp(&px[n * 3], &px[(n + 1) * 3], 3) == 0))) {
+				n++;
+			}
+			*Out++ = (uint8_t)(n - 1);
+			memcpy(Out, px, n * 3);
+			Out += n * 3;
+		}
+		px += n * 3;
+		left -= n;
+	}
+	return Out;
+}
+
+/***********************************************************************************************************/
+
+//@info The pixels of Rgb that differ from Prev, a gap of up to ANIM_GAP unchanged pixels is sent with them
+static uint8_t *ANIM_EncodeDelta(uint8_t *Out, const uint8_t *Rgb, const uint8_t *Prev, uint16_t Pixel) {
+	uint8_t *count = Out;
+	uint16_t span  = 0;
+	Out += 2;
+	for (uint32_t i = 0; i < Pixel;) {
+		uint32_t last = i;
+		if (memcmp(&Rgb[i * 3], &Prev[i * 3], 3) == 0) {
+			i++;
+			continue;
+		}
+		for (uint32_t j = i + 1; (j < Pixel) && (j <= last + ANIM_GAP + 1); j++) {
+			if (memcmp(&Rgb[j * 3], &Prev[j * 3], 3) != 0) {
+				last = j;
+			}
+		}
+		Out = ANIM_EncodeSpan(Out, Rgb, (uint16_t)i, (uint16_t)(last - i + 1));
+		span++;
+		i = last + 1;
+	}
+	ANIM_Put16(count, span);
+	return Out;
+}
+
+/***********************************************************************************************************/
+
+//@info Encode Frame raw frames of Pixel pixels into Out, which holds ANIM_FRAME_BYTES(Pixel) per frame plus the
+//      header. Returns the length, Key counts the keyframes
+static size_t ANIM_Encode(const uint8_t *Raw, uint16_t Pixel, uint16_t Frame, uint16_t Interval, uint16_t Fps, uint8_t *Out, uint16_t *Key) {
+	uint8_t *out   = Out;
+	uint8_t *delta = malloc(ANIM_FRAME_BYTES(Pixel));
+	size_t   frame = (size_t)Pixel * 3;
+	memcpy(out, WS28XX_ANIM_MAGIC, 4);
+	out  = ANIM_Put16(out + 4, Pixel);
+	out  = ANIM_Put16(out, Frame);
+	out  = ANIM_Put16(out, Fps);
+	*Key = 0;
+	for (uint32_t f = 0; f < Frame; f++) {
+		const uint8_t *rgb   = &Raw[f * frame];
+		uint8_t       *end   = ANIM_EncodeSpan(out + 2, rgb, 0, Pixel);
+		bool           key   = (f == 0) || ((Interval > 0) && ((f % Interval) == 0));
+		size_t         bytes = 0;
+		ANIM_Put16(out, 1 | WS28XX_ANIM_KEY);
+		if (key == false) {
+			bytes = (size_t)(ANIM_EncodeDelta(delta, rgb, rgb - frame, Pixel) - delta);
+		}
+		//@info a delta no smaller than the keyframe is sent as a keyframe, it is also a seek point
+		if ((key == false) && (bytes < (size_t)(end - out))) {
+			memcpy(out, delta, bytes);
+			out += bytes;
+		} else {
+			out = end;
+			(*Key)++;
+		}
+	}
+	free(delta);
+	return (size_t)(out - Out);
+}
+
+/***********************************************************************************************************/
+
+static void ANIM_Init(uint16_t Pixel) {
+	WS28XX_Init(&hLed, &hTim, ANIM_TIMER_MHZ, TIM_CHANNEL_1, Pixel);
+	HOST_TIM_Run(); //@info Let the reset frame sent by WS28XX_Init finish
+}
+
+/***********************************************************************************************************/
+
+//@info Frame of the raw animation stored like WS28XX_Animation_Next stores it, compared with the pixels
+static bool ANIM_Same(uint16_t Frame) {
+	const size_t size = ANIM_Pixel * sizeof(WS28XX_PixelTypeDef);
+	memcpy(ANIM_Saved, hLed.Pixel, size);
+	WS28XX_CopyPixel_RGB_888(&hLed, 0, ANIM_Pixel, &ANIM_Raw[(size_t)Frame * ANIM_Pixel * 3]);
+	return memcmp(ANIM_Saved, hLed.Pixel, size) == 0;
+}
+
+/***********************************************************************************************************/
+
+//@info Decode the animation twice through, to the first frame after the last, seek and cut it short
+static bool ANIM_Check(const uint8_t *Anim, size_t Size) {
+	bool same = true;
+	ANIM_Init(ANIM_Pixel);
+	same &= WS28XX_SetAnimation(&hLed, Anim, (uint32_t)Size);
+	for (uint32_t f = 0; same && (f < 2U * ANIM_Frame); f++) {
+		same &= WS28XX_Animation_Next(&hLed) && ANIM_Same((uint16_t)(f % ANIM_Frame));
+	}
+	for (uint32_t f = ANIM_Frame; same && (f-- > 0);) {
+		same &= WS28XX_Animation_Seek(&hLed, (uint16_t)f) && WS28XX_Animation_Next(&hLed) && ANIM_Same((uint16_t)f);
+	}
+	same &= (WS28XX_Animation_Seek(&hLed, ANIM_Frame) == false);
+	//@info an animation cut off in the middle of its last frame stops there
+	same &= WS28XX_SetAnimation(&hLed, Anim, (uint32_t)Size - 1);
+	for (uint32_t f = 0; same && (f < ANIM_Frame - 1U); f++) {
+		same &= WS28XX_Animation_Next(&hLed);
+	}
+	same &= (WS28XX_Animation_Next(&hLed) == false) && (hLed.Anim_Frame == ANIM_Frame - 1);
+	same &= (WS28XX_SetAnimation(&hLed, Anim, WS28XX_ANIM_HEADER) == false);
+	return same;
+}
+
+/***********************************************************************************************************/
+
+//@info One pass over the animation, decoded or stored from the raw frames, each with and without its update
+static void ANIM_Next(void) {
+	for (uint16_t f = 0; f < ANIM_Frame; f++) {
+		WS28XX_Animation_Next(&hLed);
+	}
+}
+
+static void ANIM_Next_Update(void) {
+	ANIM_Dirty = 0;
+	for (uint16_t f = 0; f < ANIM_Frame; f++) {
+		WS28XX_Animation_Next(&hLed);
+		ANIM_Dirty += (hLed.Dirty_First <= hLed.Dirty_Last) ? (hLed.Dirty_Last - hLed.Dirty_First + 1U) : 0;
+		WS28XX_Update(&hLed);
+	}
+}
+
+static void ANIM_Copy(void) {
+	for (uint16_t f = 0; f < ANIM_Frame; f++) {
+		WS28XX_CopyPixel_RGB_888(&hLed, 0, ANIM_Pixel, &ANIM_Raw[(size_t)f * ANIM_Pixel * 3]);
+	}
+}
+
+static void ANIM_Copy_Update(void) {
+	for (uint16_t f = 0; f < ANIM_Frame; f++) {
+		WS28XX_CopyPixel_RGB_888(&hLed, 0, ANIM_Pixel, &ANIM_Raw[(size_t)f * ANIM_Pixel * 3]);
+		WS28XX_Update(&hLed);
+	}
+}
+
+static void ANIM_SetPixel(void) {
+	for (uint16_t f = 0; f < ANIM_Frame; f++) {
+		const uint8_t *rgb = &ANIM_Raw[(size_t)f * ANIM_Pixel * 3];
+		for (uint16_t i = 0; i < ANIM_Pixel; i++, rgb += 3) {
+			WS28XX_SetPixel_RGB(&hLed, i, rgb[0], rgb[1], rgb[2]);
+		}
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Best time of one pass in ns per frame
+static double ANIM_Run(ANIM_FuncTypeDef Func) {
+	double best = 0;
+	for (int r = 0; r < ANIM_REPEAT; r++) {
+		uint64_t loops = 0;
+		uint64_t start = ANIM_Now();
+		uint64_t elapsed;
+		do {
+			Func();
+			loops++;
+			elapsed = ANIM_Now() - start;
+		} while (elapsed < ANIM_MIN_NS / ANIM_REPEAT);
+		double ns = (double)elapsed / (double)(loops * ANIM_Frame);
+		if ((r == 0) || (ns < best)) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+/***********************************************************************************************************/
+
+//@info A strip animation with the usual content: a still gradient, a comet with a fading tail, a blinking
+//      block and a new background every 120 frames. Frames 160 to 199 scroll a rainbow over every pixel
+static uint8_t *ANIM_Generate(uint16_t Pixel, uint16_t Frame) {
+	uint8_t *raw = malloc((size_t)Pixel * 3 * Frame);
+	for (uint32_t f = 0; f < Frame; f++) {
+		uint8_t *rgb  = &raw[(size_t)f * Pixel * 3];
+		uint32_t head = (f * 3) % Pixel;
+		uint8_t  hue  = (uint8_t)((f / 120) * 85);
+		for (uint32_t i = 0; i < Pixel; i++) {
+			uint32_t behind = (head + Pixel - i) % Pixel;
+			rgb[(i * 3) + 0] = (uint8_t)(hue + ((i * 64) / Pixel));
+			rgb[(i * 3) + 1] = 16;
+			rgb[(i * 3) + 2] = (uint8_t)(255 - hue);
+			if (behind < 24) {
+				rgb[(i * 3) + 0] = rgb[(i * 3) + 1] = rgb[(i * 3) + 2] = (uint8_t)(255 - (behind * 10));
+			}
+			if ((i >= Pixel / 2U) && (i < (Pixel / 2U) + 64) && ((f / 15) & 1)) {
+				rgb[(i * 3) + 0] = 255;
+				rgb[(i * 3) + 1] = 0;
+				rgb[(i * 3) + 2] = 0;
+			}
+			if ((f >= 160) && (f < 200)) {
+				uint8_t phase = (uint8_t)((i * 4) + (f * 8));
+				rgb[(i * 3) + 0] = phase;
+				rgb[(i * 3) + 1] = (uint8_t)(phase + 85);
+				rgb[(i * 3) + 2] = (uint8_t)(phase + 170);
+			}
+		}
+	}
+	return raw;
+}
+
+/***********************************************************************************************************/
+
+//@info Raw frames of a file, the whole frames of it
+static uint8_t *ANIM_Read(const char *Name, uint16_t Pixel, uint16_t *Frame) {
+	FILE    *file = fopen(Name, "rb");
+	uint8_t *raw  = NULL;
+	long     size;
+	if (file == NULL) {
+		return NULL;
+	}
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	*Frame = (uint16_t)(((size / 3 / Pixel) > 0xFFFF) ? 0xFFFF : (size / 3 / Pixel));
+	if (*Frame > 0) {
+		raw = malloc((size_t)*Frame * Pixel * 3);
+		if (fread(raw, (size_t)Pixel * 3, *Frame, file) != *Frame) {
+			free(raw);
+			raw = NULL;
+		}
+	}
+	fclose(file);
+	return raw;
+}
+
+/************************************************************************************************************
+**************    Public Functions
+************************************************************************************************************/
+
+int main(int argc, char **argv) {
+	uint16_t key = 0;
+	uint16_t interval = ANIM_KEY;
+	uint16_t fps      = ANIM_FPS;
+	uint8_t *raw;
+	uint8_t *anim;
+	size_t   size;
+	if (argc > 1) {
+		ANIM_Pixel = (argc > 3) ? (uint16_t)atoi(argv[2]) : 0;
+		interval   = (argc > 4) ? (uint16_t)atoi(argv[4]) : interval;
+		fps        = (argc > 5) ? (uint16_t)atoi(argv[5]) : fps;
+		if ((ANIM_Pixel == 0) || (ANIM_Pixel > WS28XX_PIXEL_MAX)) {
+			printf("usage: %s RAW PIXEL OUT [KEY] [FPS], 1 <= PIXEL <= %d\n", argv[0], WS28XX_PIXEL_MAX);
+			return EXIT_FAILURE;
+		}
+		raw = ANIM_Read(argv[1], ANIM_Pixel, &ANIM_Frame);
+		if (raw == NULL) {
+			printf("# cannot read a frame of %u pixels from %s\n", ANIM_Pixel, argv[1]);
+			return EXIT_FAILURE;
+		}
+	} else {
+		ANIM_Pixel = WS28XX_PIXEL_MAX;
+		ANIM_Frame = ANIM_FRAME;
+		raw        = ANIM_Generate(ANIM_Pixel, ANIM_Frame);
+	}
+	ANIM_Raw = raw;
+	anim     = malloc(WS28XX_ANIM_HEADER + (ANIM_FRAME_BYTES(ANIM_Pixel) * ANIM_Frame));
+	size     = ANIM_Encode(raw, ANIM_Pixel, ANIM_Frame, interval, fps, anim, &key);
+	if (ANIM_Check(anim, size) == false) {
+		printf("# decoded animation differs from the raw frames\n");
+		return EXIT_FAILURE;
+	}
+	if (argc > 1) {
+		FILE *file = fopen(argv[3], "wb");
+		if ((file == NULL) || (fwrite(anim, 1, size, file) != size)) {
+			printf("# cannot write %s\n", argv[3]);
+			return EXIT_FAILURE;
+		}
+		fclose(file);
+	}
+	printf("# anim %s: %u frames of %u pixels, %u keyframes, raw %zu bytes, encoded %zu bytes, ratio %.1f:1, decoded frames match\n", (argc > 1) ? argv[1] : "generated",
+	       ANIM_Frame, ANIM_Pixel, key, (size_t)ANIM_Frame * ANIM_Pixel * 3, size, ((double)ANIM_Frame * ANIM_Pixel * 3) / size);
+
+	ANIM_Init(ANIM_Pixel);
+	WS28XX_SetAnimation(&hLed, anim, (uint32_t)size);
+	double next = ANIM_Run(ANIM_Next);
+	double copy = ANIM_Run(ANIM_Copy);
+	printf("# anim decode [ns/pixel]: Animation_Next %.2f (%.0f MB/s of raw frames), CopyPixel_RGB_888 from raw %.2f, SetPixel_RGB from raw %.2f\n",
+	       next / ANIM_Pixel, (ANIM_Pixel * 3 * 1000.0) / next, copy / ANIM_Pixel, ANIM_Run(ANIM_SetPixel) / ANIM_Pixel);
+	next = ANIM_Run(ANIM_Next_Update);
+	printf("# anim frame + WS28XX_Update [us/frame]: Animation_Next %.1f, encoding %.0f of %u pixels on average, CopyPixel_RGB_888 from raw %.1f\n", next / 1000.0,
+	       (double)ANIM_Dirty / ANIM_Frame, ANIM_Pixel, ANIM_Run(ANIM_Copy_Update) / 1000.0);
+	free(anim);
+	free(raw);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,1587 @@
+/***********************************************************************************************************
+
+  Host benchmark for the WS28XX library.
+
+  Links ws28xx.c against the stand-in HAL in this folder and reports the cost of the public API in ns per
+  pixel for several strip lengths. Every run also prints a hash of the pulse buffer captured from
+  HAL_TIM_PWM_Start_DMA, so encoder changes can be checked for byte-identical output across builds.
+
+  Build one binary per WS28XX_ORDER / WS28XX_GAMMA combination, see Makefile.
+
+***********************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ws28xx.h"
+#if (WS28XX_QUEUE > 0)
+#	include <pthread.h>
+#	include <sched.h>
+#	include <stdatomic.h>
+#endif
+
+/************************************************************************************************************
+**************    Private Definitions
+************************************************************************************************************/
+
+#define BENCH_MIN_NS    20000000ULL
+#define BENCH_REPEAT    5
+#define BENCH_TIMER_MHZ 72
+
+typedef void (*BENCH_FuncTypeDef)(uint16_t Pixel);
+
+#if (WS28XX_QUEUE > 0)
+#	define BENCH_PRODUCER       4
+#	define BENCH_PRODUCER_PIXEL 64 //@info Pixels each producer owns, so their final state does not depend on the interleaving
+#	define BENCH_PRODUCER_POST  200000
+#endif
+
+#if (WS28XX_INGEST == true)
+#	define BENCH_INGEST_FRAME 8   //@info Frames of the test stream
+#	define BENCH_INGEST_RING  256 //@info Receive ring of the DMA stand-in
+#	define BENCH_INGEST_PIECE 64  //@info Bytes per call of the chunked timing, a UART DMA half transfer
+#	define BENCH_INGEST_BYTES (BENCH_INGEST_FRAME * ((((uint32_t)WS28XX_PIXEL_MAX + 5) * 3) + 32))
+#endif
+
+/************************************************************************************************************
+**************    Private Variables
+************************************************************************************************************/
+
+extern const uint32_t WS28XX_ReciprocalTable[];
+#if (WS28XX_GAMMA == true)
+extern const uint8_t WS28XX_GammaTable[];
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+extern void WS28XX_Transpose8(uint32_t Low, uint32_t High, uint8_t *Row);
+#endif
+
+static WS28XX_HandleTypeDef hLed;
+static TIM_TypeDef          hTimInstance;
+static TIM_HandleTypeDef    hTim;
+static DMA_HandleTypeDef    hDma     = {.Init.Mode             = (WS28XX_STREAM == true) ? DMA_CIRCULAR : DMA_NORMAL,
+                                        .Init.MemInc           = DMA_MINC_ENABLE,
+                                        .Init.MemDataAlignment = (WS28XX_BYTE_PULSE == true) ? DMA_MDATAALIGN_BYTE : DMA_MDATAALIGN_HALFWORD,
+                                        .Parent                = &hTim};
+static DMA_HandleTypeDef    hDmaUp   = {.Init.Mode = DMA_NORMAL, .Init.MemInc = DMA_MINC_DISABLE, .Parent = &hTim};
+static DMA_HandleTypeDef    hDmaCc2  = {.Init.Mode = DMA_NORMAL, .Init.MemInc = DMA_MINC_DISABLE, .Parent = &hTim};
+static TIM_HandleTypeDef    hTim     = {.Instance = &hTimInstance, .hdma[TIM_DMA_ID_UPDATE] = &hDmaUp, .hdma[TIM_DMA_ID_CC1] = &hDma, .hdma[TIM_DMA_ID_CC2] = &hDmaCc2};
+#if (WS28XX_GPIO_LANE > 0)
+static GPIO_TypeDef         hGpio;
+#endif
+#if (WS28XX_SPI_SYMBOL > 0)
+static SPI_HandleTypeDef    hSpi;
+#endif
+#if (WS28XX_EXTERNAL_BUFFER == true) && (WS28XX_FRAMEBUFFER == false)
+static WS28XX_PixelTypeDef  BENCH_Pixel[WS28XX_PIXEL_MAX];
+#endif
+#if (WS28XX_EXTERNAL_BUFFER == true)
+static WS28XX_SlotTypeDef   BENCH_Pulse[WS28XX_PULSE_BUFFER(WS28XX_PIXEL_MAX)];
+#endif
+static uint16_t             BENCH_Log[(((WS28XX_PIXEL_MAX * WS28XX_PIXEL_SLOT) + 2) * 2) + 4096]; //@info Room for two frames
+static uint8_t              BENCH_Rgb[WS28XX_PIXEL_MAX * 4];   //@info Source image of the bulk setters, RGB888 or raw
+#if (WS28XX_FRAMEBUFFER == true)
+#	define BENCH_FRAME_BYTES ((WS28XX_COLOR_CHANNEL == 4) ? 4 : 3)
+static uint8_t              BENCH_Frame[WS28XX_PIXEL_MAX * 4]; //@info Frame of WS28XX_SetFrameBuffer, RGB888 or RGBW8888
+//@info Byte of red, green and blue in each WS28XX_ORDER, as WS28XX_SetFrameBuffer maps them
+static const uint8_t        BENCH_OrderIndex[3][3] = {{0, 1, 2}, {2, 1, 0}, {1, 0, 2}};
+#else
+static uint16_t             BENCH_Rgb565[WS28XX_PIXEL_MAX];
+static WS28XX_PixelTypeDef  BENCH_Saved[WS28XX_PIXEL_MAX];
+#endif
+
+#if (WS28XX_MATRIX == true)
+#	define BENCH_MATRIX_SIDE 32 //@info Square matrix of the timings, 4 x 4 serpentine tiles of 8 x 8
+static uint16_t             BENCH_Map[WS28XX_PIXEL_MAX];
+static WS28XX_PixelTypeDef  BENCH_Drawn[WS28XX_PIXEL_MAX];
+#endif
+
+#if (WS28XX_QUEUE > 0)
+static WS28XX_HandleTypeDef hRef; //@info Same commands applied with the setters, in the order of each producer
+#	if (WS28XX_EXTERNAL_BUFFER == true)
+static WS28XX_PixelTypeDef  BENCH_RefPixel[BENCH_PRODUCER * BENCH_PRODUCER_PIXEL];
+#	endif
+static atomic_uint          BENCH_Producing;
+#endif
+
+#if (WS28XX_INGEST == true)
+static uint8_t              BENCH_Stream[BENCH_INGEST_BYTES]; //@info Adalight frames of BENCH_IngestBuild
+static uint32_t             BENCH_StreamLength;
+static WS28XX_PixelTypeDef  BENCH_IngestPixel[BENCH_INGEST_FRAME][WS28XX_PIXEL_MAX]; //@info Pixels each frame must leave
+#endif
+
+static const uint16_t BENCH_Length[] = {8, 32, 256, 1024, WS28XX_PIXEL_MAX};
+static volatile uint32_t BENCH_Sink;
+static volatile uint32_t BENCH_Frames;
+
+/************************************************************************************************************
+**************    Private Functions
+************************************************************************************************************/
+
+static uint64_t BENCH_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/***********************************************************************************************************/
+
+static uint32_t BENCH_Hash(const uint16_t *Data, uint32_t Length) {
+	uint32_t hash = 2166136261U;
+	for (uint32_t i = 0; i < Length; i++) {
+		hash = (hash ^ (Data[i] & 0xFF)) * 16777619U;
+		hash = (hash ^ (Data[i] >> 8)) * 16777619U;
+	}
+	return hash;
+}
+
+/***********************************************************************************************************/
+
+static uint32_t BENCH_Color(uint32_t Index) {
+	uint32_t x = (Index + 1) * 2654435761U;
+	return (x ^ (x >> 15)) & 0xFFFFFF;
+}
+
+/***********************************************************************************************************/
+
+static void BENCH_Fill(uint16_t Pixel) {
+#if (WS28XX_FRAMEBUFFER == true)
+	//@info The same colors as the setters get, drawn into the frame in RGB order
+	for (uint16_t i = 0; i < Pixel; i++) {
+		uint8_t *rgb = &BENCH_Frame[i * BENCH_FRAME_BYTES];
+		uint32_t color = BENCH_Color(i);
+		rgb[0]         = (uint8_t)(color >> 16);
+		rgb[1]         = (uint8_t)(color >> 8);
+		rgb[2]         = (uint8_t)color;
+#	if (WS28XX_COLOR_CHANNEL == 4)
+		rgb[3] = (uint8_t)BENCH_Color(~i);
+#	endif
+	}
+	WS28XX_SetFrameBuffer(&hLed, BENCH_Frame, (WS28XX_COLOR_CHANNEL == 4) ? WS28XX_FORMAT_8888 : WS28XX_FORMAT_888, WS28XX_ORDER_RGB);
+#else
+	for (uint16_t i = 0; i < Pixel; i++) {
+#	if (WS28XX_COLOR_CHANNEL == 4)
+		uint32_t color = BENCH_Color(i);
+		WS28XX_SetPixel_RGB_White(&hLed, i, (uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color, (uint8_t)BENCH_Color(~i));
+#	else
+		WS28XX_SetPixel_RGB_888(&hLed, i, BENCH_Color(i));
+#	endif
+	}
+#endif
+}
+
+/***********************************************************************************************************/
+
+//@info Send one frame through the stand-in DMA, recording it in BENCH_Log when Log is set
+static void BENCH_Send(bool Log) {
+	HOST_TIM_Reset();
+	if (Log) {
+		HOST_TIM_Capture.Log      = BENCH_Log;
+		HOST_TIM_Capture.Log_Size = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+	}
+	WS28XX_Update(&hLed);
+	HOST_TIM_Run();
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_GAMMA == false)
+//@info Byte Channel of a stored pixel as it must be sent, with the grey part moved to white when enabled
+static uint8_t BENCH_Expect(uint16_t Pixel, uint8_t Channel) {
+#if (WS28XX_FRAMEBUFFER == true)
+	const uint8_t *rgb = &BENCH_Frame[Pixel * BENCH_FRAME_BYTES];
+	uint8_t        color[4];
+	for (uint8_t c = 0; c < 3; c++) {
+		color[BENCH_OrderIndex[WS28XX_ORDER][c]] = rgb[c];
+	}
+	color[3] = (WS28XX_COLOR_CHANNEL == 4) ? rgb[BENCH_FRAME_BYTES - 1] : 0;
+#else
+	const uint8_t *color = hLed.Pixel[Pixel].Color;
+#endif
+#if (WS28XX_WHITE_EXTRACT == true)
+	uint8_t grey = color[0];
+	for (uint8_t ch = 1; ch < 3; ch++) {
+		grey = (color[ch] < grey) ? color[ch] : grey;
+	}
+	if (Channel == 3) {
+		return ((color[3] + grey) > 255) ? 255 : (uint8_t)(color[3] + grey);
+	}
+	return (uint8_t)(color[Channel] - grey);
+#else
+	return color[Channel];
+#endif
+}
+
+/***********************************************************************************************************/
+
+//@info Decode the high times of every Stride-th slot in BENCH_Log from slot Start on back to bytes and compare
+//      them with Count stored pixels from Pixel on
+static bool BENCH_Verify(uint32_t Start, uint32_t Stride, uint16_t Pixel, uint16_t Count) {
+	uint32_t bit = 0;
+	uint8_t  byte = 0;
+	uint32_t count = 0;
+	for (uint32_t i = Start; i < HOST_TIM_Capture.Log_Length; i += Stride) {
+		uint16_t slot = BENCH_Log[i];
+		if (slot == 0) {
+			continue;
+		}
+		byte = (uint8_t)((byte << 1) | (slot == hLed.Pulse1));
+		if (++bit == 8) {
+			if (count >= (uint32_t)Count * WS28XX_COLOR_CHANNEL || byte != BENCH_Expect(Pixel + (count / WS28XX_COLOR_CHANNEL), count % WS28XX_COLOR_CHANNEL)) {
+				return false;
+			}
+			count++;
+			bit = 0;
+		}
+	}
+	return count == (uint32_t)Count * WS28XX_COLOR_CHANNEL;
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_GPIO_LANE > 0)
+//@info Decode lane by lane the port states logged between Pulse0 and Pulse1, one per bit of every strip
+static bool BENCH_VerifyGpio(uint32_t Start) {
+	uint32_t length = (uint32_t)hLed.Strip_Pixel * WS28XX_PIXEL_SLOT;
+	if (HOST_TIM_Capture.Log_Length < Start + length) {
+		return false;
+	}
+	for (uint8_t lane = 0; lane < WS28XX_GPIO_LANE; lane++) {
+		uint8_t byte = 0;
+		for (uint32_t i = 0; i < length; i++) {
+			byte = (uint8_t)((byte << 1) | ((BENCH_Log[Start + i] >> lane) & 1));
+			if ((i & 7) == 7 && byte != BENCH_Expect((lane * hLed.Strip_Pixel) + (i / WS28XX_PIXEL_SLOT), (i / 8) % WS28XX_COLOR_CHANNEL)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0)
+//@info Decode the SPI bytes logged from slot Start on as a waveform: every high run is one bit, longer than the
+//      middle of WS28XX_PULSE_0_NS and WS28XX_PULSE_1_NS is a 1. Each high time must be within 150 ns of its pulse
+static bool BENCH_VerifySpi(uint32_t Start) {
+	const double bit_ns = (double)WS28XX_PULSE_LENGTH_NS / WS28XX_SPI_SYMBOL;
+	uint32_t     high   = 0;
+	uint32_t     bit    = 0;
+	uint8_t      byte   = 0;
+	uint32_t     count  = 0;
+	for (uint32_t i = Start; i < HOST_TIM_Capture.Log_Length; i++) {
+		for (int b = 7; b >= 0; b--) {
+			if ((BENCH_Log[i] >> b) & 1) {
+				high++;
+				continue;
+			}
+			if (high != 0) {
+				double ns    = high * bit_ns;
+				bool   one   = ns > ((WS28XX_PULSE_0_NS + WS28XX_PULSE_1_NS) / 2.0);
+				double error = ns - (one ? WS28XX_PULSE_1_NS : WS28XX_PULSE_0_NS);
+				if (error > 150.0 || error < -150.0) {
+					return false;
+				}
+				byte = (uint8_t)((byte << 1) | one);
+				high = 0;
+				if (++bit == 8) {
+					if (count >= (uint32_t)hLed.Num_Pixel * WS28XX_COLOR_CHANNEL || byte != BENCH_Expect(count / WS28XX_COLOR_CHANNEL, count % WS28XX_COLOR_CHANNEL)) {
+						return false;
+					}
+					count++;
+					bit = 0;
+				}
+			}
+		}
+	}
+	return count == (uint32_t)hLed.Num_Pixel * WS28XX_COLOR_CHANNEL;
+}
+#endif
+
+/***********************************************************************************************************/
+
+//@info Verify the frame logged from slot Start on, each strip of a multi channel handle on its own
+static bool BENCH_VerifyFrame(uint32_t Start) {
+	uint8_t  strip = 1;
+	uint16_t pixel = hLed.Num_Pixel;
+#if (WS28XX_GPIO_LANE > 0)
+	return BENCH_VerifyGpio(Start);
+#endif
+#if (WS28XX_SPI_SYMBOL > 0)
+	return BENCH_VerifySpi(Start);
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+	strip = hLed.Num_Strip;
+	pixel = hLed.Strip_Pixel;
+#endif
+	for (uint8_t s = 0; s < strip; s++) {
+		if (BENCH_Verify(Start + s, strip, s * pixel, pixel) == false) {
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
+#if (WS28XX_SCHEDULER == true) || ((WS28XX_STREAM == false) && (WS28XX_DOUBLE_BUFFER == false) && (WS28XX_SPI_SYMBOL == 0) && (WS28XX_GAMMA == false))
+/***********************************************************************************************************/
+
+//@info Low periods logged after the first frame of BENCH_Log, Next gets the slot the frame after them starts at
+static uint32_t BENCH_LatchGap(uint32_t *Next) {
+	uint32_t stride = 1;
+	uint32_t end;
+	uint32_t gap = 0;
+#if (WS28XX_SPI_SYMBOL > 0)
+	end = 1 + ((uint32_t)hLed.Num_Pixel * WS28XX_COLOR_CHANNEL * WS28XX_SPI_SYMBOL);
+	while ((end + gap < HOST_TIM_Capture.Log_Length) && (BENCH_Log[end + gap] == 0)) {
+		gap++;
+	}
+	//@info the log holds bytes, a period is WS28XX_SPI_SYMBOL bits
+	*Next = end + WS28XX_SPI_LATCH;
+	return (gap * 8) / WS28XX_SPI_SYMBOL;
+#elif (WS28XX_STREAM == true)
+	end = (uint32_t)hLed.Num_Pixel * WS28XX_PIXEL_SLOT;
+#elif (WS28XX_GPIO_LANE > 0)
+	end = (uint32_t)hLed.Strip_Pixel * WS28XX_PIXEL_SLOT;
+#elif (WS28XX_MULTI_CHANNEL > 1)
+	stride = hLed.Num_Strip;
+	end    = (1 + ((uint32_t)hLed.Strip_Pixel * WS28XX_PIXEL_SLOT)) * stride;
+#else
+	end = 1 + ((uint32_t)hLed.Num_Pixel * WS28XX_PIXEL_SLOT);
+#endif
+	while ((end + gap < HOST_TIM_Capture.Log_Length) && (BENCH_Log[end + gap] == 0)) {
+		gap++;
+	}
+	*Next = end + (hLed.Reset_Slot * stride);
+	return gap / stride;
+}
+#endif
+
+/***********************************************************************************************************/
+
+void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PulseFinishedCallback(&hLed, htim);
+}
+
+void HAL_TIM_PWM_PulseFinishedHalfCpltCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PulseFinishedHalfCpltCallback(&hLed, htim);
+}
+
+#if (WS28XX_SPI_SYMBOL > 0)
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+	WS28XX_SpiTxCpltCallback(&hLed, hspi);
+}
+#endif
+
+#if (WS28XX_MULTI_CHANNEL > 1)
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PeriodElapsedCallback(&hLed, htim);
+}
+#endif
+
+void WS28XX_FrameDoneCallback(WS28XX_HandleTypeDef *Handle) {
+	(void)Handle;
+	BENCH_Frames++;
+}
+
+/***********************************************************************************************************/
+
+static double BENCH_Run(BENCH_FuncTypeDef Func, uint16_t Pixel) {
+	double best = 0;
+	for (int r = 0; r < BENCH_REPEAT; r++) {
+		uint64_t loops = 0;
+		uint64_t start = BENCH_Now();
+		uint64_t elapsed;
+		do {
+			Func(Pixel);
+			loops++;
+			elapsed = BENCH_Now() - start;
+		} while (elapsed < BENCH_MIN_NS / BENCH_REPEAT);
+		double ns = (double)elapsed / (double)(loops * Pixel);
+		if (r == 0 || ns < best) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+#if (WS28XX_MATRIX == true)
+/***********************************************************************************************************/
+
+//@info X, Y of position Index in a Width x Height block wired in Layout, walked the other way than the library
+static void BENCH_LayoutXY(uint8_t Layout, uint16_t Index, uint16_t Width, uint16_t Height, uint16_t *X, uint16_t *Y) {
+	bool column = (Layout == WS28XX_LAYOUT_COLUMN) || (Layout == WS28XX_LAYOUT_COLUMN_SERPENTINE);
+	bool snake  = (Layout == WS28XX_LAYOUT_SERPENTINE) || (Layout == WS28XX_LAYOUT_COLUMN_SERPENTINE);
+	uint16_t line   = Index / (column ? Height : Width);
+	uint16_t along  = Index % (column ? Height : Width);
+	if (snake && (line & 1)) {
+		along = (column ? Height : Width) - 1 - along;
+	}
+	*X = column ? line : along;
+	*Y = column ? along : line;
+}
+
+/***********************************************************************************************************/
+
+//@info Walk the strip and check that every pixel sits in the map where the matrix puts it
+static bool BENCH_MatrixCheck(const WS28XX_MatrixTypeDef *Matrix) {
+	uint16_t tile_size = Matrix->Tile_Width * Matrix->Tile_Height;
+	for (uint16_t i = 0; i < Matrix->Width * Matrix->Height; i++) {
+		uint16_t tx, ty, ix, iy, px, py, x, y;
+		BENCH_LayoutXY(Matrix->Tile_Layout, i / tile_size, Matrix->Width / Matrix->Tile_Width, Matrix->Height / Matrix->Tile_Height, &tx, &ty);
+		BENCH_LayoutXY(Matrix->Layout, i % tile_size, Matrix->Tile_Width, Matrix->Tile_Height, &ix, &iy);
+		px = (tx * Matrix->Tile_Width) + ix;
+		py = (ty * Matrix->Tile_Height) + iy;
+		switch (Matrix->Rotate) {
+			case WS28XX_ROTATE_90:
+				x = py;
+				y = Matrix->Width - 1 - px;
+				break;
+			case WS28XX_ROTATE_180:
+				x = Matrix->Width - 1 - px;
+				y = Matrix->Height - 1 - py;
+				break;
+			case WS28XX_ROTATE_270:
+				x = Matrix->Height - 1 - py;
+				y = px;
+				break;
+			default:
+				x = px;
+				y = py;
+				break;
+		}
+		if (BENCH_Map[(y * hLed.Matrix_Width) + x] != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/***********************************************************************************************************/
+
+//@info Draw Width x Height at X, Y pixel by pixel, an image or one color, skipping what is off the matrix
+static void BENCH_MatrixDraw(int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const uint8_t *Rgb) {
+	for (int32_t y = 0; y < Height; y++) {
+		for (int32_t x = 0; x < Width; x++) {
+			const uint8_t *src = (Rgb == NULL) ? (const uint8_t *)"\x12\x34\x56" : &Rgb[((y * Width) + x) * 3];
+			if ((X + x >= 0) && (Y + y >= 0)) {
+				WS28XX_Matrix_SetPixel_RGB(&hLed, (uint16_t)(X + x), (uint16_t)(Y + y), src[0], src[1], src[2]);
+			}
+		}
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info The index math the matrix map replaces, serpentine 8 x 8 tiles in serpentine order, then the setter
+static void BENCH_Matrix_Arithmetic(uint16_t Pixel) {
+	const uint8_t *rgb = BENCH_Rgb;
+	for (uint16_t y = 0; y < BENCH_MATRIX_SIDE; y++) {
+		for (uint16_t x = 0; x < BENCH_MATRIX_SIDE; x++, rgb += 3) {
+			uint16_t ty = y / 8, iy = y % 8;
+			uint16_t tx = (ty & 1) ? (BENCH_MATRIX_SIDE / 8) - 1 - (x / 8) : x / 8;
+			uint16_t ix = (iy & 1) ? 7 - (x % 8) : x % 8;
+			WS28XX_SetPixel_RGB(&hLed, (((ty * (BENCH_MATRIX_SIDE / 8)) + tx) * 64) + (iy * 8) + ix, rgb[0], rgb[1], rgb[2]);
+		}
+	}
+	(void)Pixel;
+}
+
+static void BENCH_Matrix_SetPixel_RGB(uint16_t Pixel) {
+	const uint8_t *rgb = BENCH_Rgb;
+	for (uint16_t y = 0; y < BENCH_MATRIX_SIDE; y++) {
+		for (uint16_t x = 0; x < BENCH_MATRIX_SIDE; x++, rgb += 3) {
+			WS28XX_Matrix_SetPixel_RGB(&hLed, x, y, rgb[0], rgb[1], rgb[2]);
+		}
+	}
+	(void)Pixel;
+}
+
+static void BENCH_Matrix_Blit_RGB_888(uint16_t Pixel) {
+	WS28XX_Matrix_Blit_RGB_888(&hLed, 0, 0, BENCH_MATRIX_SIDE, BENCH_MATRIX_SIDE, BENCH_Rgb);
+	(void)Pixel;
+}
+
+static void BENCH_Matrix_FillRect_RGB(uint16_t Pixel) {
+	WS28XX_Matrix_FillRect_RGB(&hLed, 0, 0, BENCH_MATRIX_SIDE, BENCH_MATRIX_SIDE, 1, 2, (uint8_t)BENCH_Sink++);
+	(void)Pixel;
+}
+#endif
+
+#if (WS28XX_INGEST == true)
+/***********************************************************************************************************/
+
+//@info The first frame of BENCH_Stream in one call, in UART sized pieces and byte by byte
+static void BENCH_Ingest(uint16_t Pixel) {
+	WS28XX_Ingest(&hLed, BENCH_Stream, BENCH_StreamLength);
+	(void)Pixel;
+}
+
+static void BENCH_Ingest_Piece(uint16_t Pixel) {
+	for (uint32_t i = 0; i < BENCH_StreamLength; i += BENCH_INGEST_PIECE) {
+		WS28XX_Ingest(&hLed, &BENCH_Stream[i], ((BENCH_StreamLength - i) < BENCH_INGEST_PIECE) ? (BENCH_StreamLength - i) : BENCH_INGEST_PIECE);
+	}
+	(void)Pixel;
+}
+
+static void BENCH_Ingest_Byte(uint16_t Pixel) {
+	for (uint32_t i = 0; i < BENCH_StreamLength; i++) {
+		WS28XX_Ingest(&hLed, &BENCH_Stream[i], 1);
+	}
+	(void)Pixel;
+}
+
+//@info What the ingest replaces: the whole frame received first, then the header checked and one setter call per LED
+static void BENCH_Ingest_SetPixel(uint16_t Pixel) {
+	const uint8_t *rgb   = &BENCH_Stream[6];
+	uint32_t       count = ((BENCH_Stream[3] << 8) | BENCH_Stream[4]) + 1;
+	if ((memcmp(BENCH_Stream, "Ada", 3) == 0) && (BENCH_Stream[5] == (BENCH_Stream[3] ^ BENCH_Stream[4] ^ 0x55))) {
+		for (uint32_t i = 0; (i < count) && (i < hLed.Num_Pixel); i++, rgb += 3) {
+			WS28XX_SetPixel_RGB(&hLed, (uint16_t)i, rgb[0], rgb[1], rgb[2]);
+		}
+		WS28XX_Update(&hLed);
+	}
+	(void)Pixel;
+}
+
+//@info The WS28XX_Update of every frame, the same share of both
+static void BENCH_Ingest_Update(uint16_t Pixel) {
+	WS28XX_Refresh(&hLed);
+	WS28XX_Update(&hLed);
+	(void)Pixel;
+}
+#endif
+
+#if (WS28XX_QUEUE > 0)
+/***********************************************************************************************************/
+
+//@info Command Index of a producer, posted to hLed or applied to hRef with the setter it stands for. The last
+//      commands set every owned pixel once so the decoded frame can be checked at full brightness
+static bool BENCH_Command(uint8_t Producer, uint32_t Index, bool Post) {
+	uint16_t base  = Producer * BENCH_PRODUCER_PIXEL;
+	uint16_t pixel = base + (Index % BENCH_PRODUCER_PIXEL);
+	uint32_t color = BENCH_Color(((uint32_t)Producer << 24) ^ Index);
+	uint8_t  red = (uint8_t)(color >> 16), green = (uint8_t)(color >> 8), blue = (uint8_t)color;
+	if (Index >= BENCH_PRODUCER_POST - BENCH_PRODUCER_PIXEL) {
+		return Post ? WS28XX_Post_Pixel(&hLed, pixel, red, green, blue) : WS28XX_SetPixel_RGB(&hRef, pixel, red, green, blue);
+	}
+	if (Index % 997 == 0) {
+		return Post ? WS28XX_Post_Fill(&hLed, base, BENCH_PRODUCER_PIXEL, red, green, blue) : WS28XX_FillPixel_RGB(&hRef, base, BENCH_PRODUCER_PIXEL, red, green, blue);
+	}
+	if (Index % 101 == 0) {
+		return Post ? WS28XX_Post_Brightness(&hLed, base + (Index % 32), 16, (uint8_t)Index) : WS28XX_SetRangePixel_Brightness(&hRef, base + (Index % 32), 16, (uint8_t)Index);
+	}
+	return Post ? WS28XX_Post_Pixel(&hLed, pixel, red, green, blue) : WS28XX_SetPixel_RGB(&hRef, pixel, red, green, blue);
+}
+
+/***********************************************************************************************************/
+
+//@info Post every command of one producer, retrying while the ring is full
+static void *BENCH_Producer(void *Arg) {
+	uint8_t producer = (uint8_t)(uintptr_t)Arg;
+	for (uint32_t i = 0; i < BENCH_PRODUCER_POST; i++) {
+		while (BENCH_Command(producer, i, true) == false) {
+			sched_yield();
+		}
+	}
+	atomic_fetch_sub(&BENCH_Producing, 1);
+	return NULL;
+}
+#endif
+
+/************************************************************************************************************
+**************    Benchmarks
+************************************************************************************************************/
+
+static void BENCH_Update(uint16_t Pixel) {
+	(void)Pixel;
+	WS28XX_Refresh(&hLed);
+	BENCH_Send(false);
+}
+
+static void BENCH_Update_OneDirty(uint16_t Pixel) {
+	uint32_t i = BENCH_Sink++;
+#if (WS28XX_FRAMEBUFFER == true)
+	BENCH_Frame[(i % Pixel) * BENCH_FRAME_BYTES] = (uint8_t)BENCH_Color(i);
+	WS28XX_RefreshRange(&hLed, (uint16_t)(i % Pixel), 1);
+#else
+	WS28XX_SetPixel_RGB_888(&hLed, (uint16_t)(i % Pixel), BENCH_Color(i));
+#endif
+	BENCH_Send(false);
+}
+
+static void BENCH_Update_Clean(uint16_t Pixel) {
+	(void)Pixel;
+	BENCH_Send(false);
+}
+
+#if (WS28XX_FRAMEBUFFER == false)
+static void BENCH_SetPixel_RGB(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGB(&hLed, i, (uint8_t)i, (uint8_t)(i >> 1), (uint8_t)(i >> 2));
+	}
+}
+
+static void BENCH_SetPixel_RGB_565(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGB_565(&hLed, i, (uint16_t)(i * 40503U));
+	}
+}
+
+static void BENCH_SetPixel_RGB_888(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGB_888(&hLed, i, i * 2654435761U);
+	}
+}
+
+static void BENCH_SetPixel_RGBW(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGBW(&hLed, i, (uint8_t)i, (uint8_t)(i >> 1), (uint8_t)(i >> 2), (uint8_t)(i * 3));
+	}
+}
+
+static void BENCH_SetPixel_RGBW_565(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGBW_565(&hLed, i, (uint16_t)(i * 40503U), (uint8_t)(i * 3));
+	}
+}
+
+static void BENCH_SetPixel_RGBW_888(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGBW_888(&hLed, i, i * 2654435761U, (uint8_t)(i * 3));
+	}
+}
+#endif
+
+//@info Brightness scaling as WS28XX_Update did it before the reciprocal table, three divisions per pixel
+static inline uint8_t BENCH_ScaleDivision(uint8_t Color, uint8_t Brightness, uint8_t Max) {
+	uint16_t BRIGHTNESS_SCALE = RESOLUTION_OF_BRIGHTNESS * Brightness / Max;
+	return (uint8_t)((Color * BRIGHTNESS_SCALE) / RESOLUTION_OF_BRIGHTNESS);
+}
+
+//@info Brightness scaling of WS28XX_EncodePixel
+static inline uint8_t BENCH_ScaleReciprocal(uint8_t Color, uint8_t Brightness, uint8_t Max) {
+	uint32_t scale = ((Brightness * WS28XX_ReciprocalTable[Max]) + 0x80) >> 8;
+	return (uint8_t)(((Color * scale) + 0x8000) >> 16);
+}
+
+#if (WS28XX_FRAMEBUFFER == false)
+static void BENCH_Scale_Division(uint16_t Pixel) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_PixelTypeDef px  = hLed.Pixel[i];
+		uint8_t             max = MAX_OF_THREE(px.Color[0], px.Color[1], px.Color[2]);
+		if (max != 0) {
+			for (uint8_t c = 0; c < 3; c++) {
+				sum += BENCH_ScaleDivision(px.Color[c], px.Brightness, max);
+			}
+		}
+	}
+	BENCH_Sink += sum;
+}
+
+static void BENCH_Scale_Reciprocal(uint16_t Pixel) {
+	uint32_t sum = 0;
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_PixelTypeDef px  = hLed.Pixel[i];
+		uint8_t             max = MAX_OF_THREE(px.Color[0], px.Color[1], px.Color[2]);
+		if (max != 0) {
+			for (uint8_t c = 0; c < 3; c++) {
+				sum += BENCH_ScaleReciprocal(px.Color[c], px.Brightness, max);
+			}
+		}
+	}
+	BENCH_Sink += sum;
+}
+#endif
+
+//@info Largest distance of both scaling methods to the exact Color * Brightness / Max over every input
+static void BENCH_ScaleAccuracy(void) {
+	double division = 0, reciprocal = 0;
+	for (uint16_t max = 1; max < 256; max++) {
+		for (uint16_t brightness = 1; brightness < 256; brightness++) {
+			for (uint16_t color = 0; color <= max; color++) {
+				double exact = (double)color * brightness / max;
+				double d     = exact - BENCH_ScaleDivision((uint8_t)color, (uint8_t)brightness, (uint8_t)max);
+				double r     = exact - BENCH_ScaleReciprocal((uint8_t)color, (uint8_t)brightness, (uint8_t)max);
+				division     = (d < 0 ? -d : d) > division ? (d < 0 ? -d : d) : division;
+				reciprocal   = (r < 0 ? -r : r) > reciprocal ? (r < 0 ? -r : r) : reciprocal;
+			}
+		}
+	}
+	printf("# brightness scaling max error: division %.3f, reciprocal %.3f\n", division, reciprocal);
+}
+
+#if (WS28XX_GPIO_LANE > 0)
+//@info Transpose of 8 lane bytes one bit at a time, as the GPIO backend would do it without WS28XX_Transpose8
+static inline void BENCH_TransposeLoop(const uint8_t *Lane, uint8_t *Row) {
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		uint8_t row = 0;
+		for (uint8_t lane = 0; lane < 8; lane++) {
+			row |= (uint8_t)(((Lane[lane] >> (7 - bit)) & 1) << lane);
+		}
+		Row[bit] = row;
+	}
+}
+
+static inline void BENCH_TransposeSwar(const uint8_t *Lane, uint8_t *Row) {
+	uint32_t low, high;
+	memcpy(&low, Lane, 4);
+	memcpy(&high, Lane + 4, 4);
+	WS28XX_Transpose8(low, high, Row);
+}
+
+//@info Both transposes over the 3 bytes of every pixel, 8 lanes at a time
+static void BENCH_Transpose_Loop(uint16_t Pixel) {
+	const uint8_t *data = BENCH_Rgb;
+	uint8_t        row[8];
+	uint32_t       sum = 0;
+	for (uint32_t i = 0; i + 8 <= (uint32_t)Pixel * 3; i += 8) {
+		BENCH_TransposeLoop(&data[i], row);
+		sum += row[0] ^ row[7];
+	}
+	BENCH_Sink += sum;
+}
+
+static void BENCH_Transpose_Swar(uint16_t Pixel) {
+	const uint8_t *data = BENCH_Rgb;
+	uint8_t        row[8];
+	uint32_t       sum = 0;
+	for (uint32_t i = 0; i + 8 <= (uint32_t)Pixel * 3; i += 8) {
+		BENCH_TransposeSwar(&data[i], row);
+		sum += row[0] ^ row[7];
+	}
+	BENCH_Sink += sum;
+}
+
+//@info Compare both transposes on random lane bytes
+static bool BENCH_TransposeCheck(void) {
+	uint32_t x = 1;
+	for (uint32_t n = 0; n < 1000000; n++) {
+		uint8_t lane[8], loop[8], swar[8];
+		for (uint8_t i = 0; i < 8; i++) {
+			x       = (x * 1103515245U) + 12345U;
+			lane[i] = (uint8_t)(x >> 16);
+		}
+		BENCH_TransposeLoop(lane, loop);
+		BENCH_TransposeSwar(lane, swar);
+		if (memcmp(loop, swar, sizeof(loop)) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
+static void BENCH_SetAllPixel_Brightness(uint16_t Pixel) {
+	(void)Pixel;
+	WS28XX_SetAllPixel_Brightness(&hLed, (uint8_t)BENCH_Sink++);
+}
+
+#if (WS28XX_FRAMEBUFFER == false)
+static void BENCH_SetOnePixel_Brightness(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetOnePixel_Brightness(&hLed, i, (uint8_t)(i * 7));
+	}
+}
+
+static void BENCH_SetPixel_RGB_Fill(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGB(&hLed, i, 255, 128, 16);
+	}
+}
+
+static void BENCH_FillPixel_RGB(uint16_t Pixel) {
+	WS28XX_FillPixel_RGB(&hLed, 0, Pixel, 255, 128, 16);
+}
+
+static void BENCH_SetPixel_RGB_Image(uint16_t Pixel) {
+	const uint8_t *rgb = BENCH_Rgb;
+	for (uint16_t i = 0; i < Pixel; i++, rgb += 3) {
+		WS28XX_SetPixel_RGB(&hLed, i, rgb[0], rgb[1], rgb[2]);
+	}
+}
+
+static void BENCH_CopyPixel_RGB_888(uint16_t Pixel) {
+	WS28XX_CopyPixel_RGB_888(&hLed, 0, Pixel, BENCH_Rgb);
+}
+
+static void BENCH_SetPixel_RGB_565_Image(uint16_t Pixel) {
+	for (uint16_t i = 0; i < Pixel; i++) {
+		WS28XX_SetPixel_RGB_565(&hLed, i, BENCH_Rgb565[i]);
+	}
+}
+
+static void BENCH_CopyPixel_RGB_565(uint16_t Pixel) {
+	WS28XX_CopyPixel_RGB_565(&hLed, 0, Pixel, BENCH_Rgb565);
+}
+
+static void BENCH_CopyPixel_Raw(uint16_t Pixel) {
+	WS28XX_CopyPixel_Raw(&hLed, 0, Pixel, BENCH_Rgb);
+}
+
+static void BENCH_SetRangePixel_Brightness(uint16_t Pixel) {
+	WS28XX_SetRangePixel_Brightness(&hLed, 0, Pixel, (uint8_t)BENCH_Sink++);
+}
+
+//@info Every bulk setter must leave the pixels exactly like the per-pixel calls it replaces
+static bool BENCH_BulkCheck(void) {
+	const uint16_t count = WS28XX_PIXEL_MAX;
+	const size_t   size  = count * sizeof(WS28XX_PixelTypeDef);
+	bool           same  = true;
+	BENCH_SetPixel_RGB_Image(count);
+	memcpy(BENCH_Saved, hLed.Pixel, size);
+	BENCH_CopyPixel_RGB_888(count);
+	same &= (memcmp(BENCH_Saved, hLed.Pixel, size) == 0);
+	BENCH_SetPixel_RGB_565_Image(count);
+	memcpy(BENCH_Saved, hLed.Pixel, size);
+	BENCH_CopyPixel_RGB_565(count);
+	same &= (memcmp(BENCH_Saved, hLed.Pixel, size) == 0);
+	BENCH_SetPixel_RGB_Fill(count);
+	memcpy(BENCH_Saved, hLed.Pixel, size);
+	BENCH_FillPixel_RGB(count);
+	same &= (memcmp(BENCH_Saved, hLed.Pixel, size) == 0);
+	for (uint16_t i = 100; i < 200; i++) {
+		WS28XX_SetOnePixel_Brightness(&hLed, i, 77);
+	}
+	memcpy(BENCH_Saved, hLed.Pixel, size);
+	BENCH_FillPixel_RGB(count);
+	WS28XX_SetRangePixel_Brightness(&hLed, 100, 100, 77);
+	same &= (memcmp(BENCH_Saved, hLed.Pixel, size) == 0);
+	//@info raw bytes are in WS28XX_ORDER, gamma applies to every channel
+	BENCH_CopyPixel_Raw(count);
+	for (uint16_t i = 0; (i < count) && same; i++) {
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+#if (WS28XX_GAMMA == true)
+			same &= (hLed.Pixel[i].Color[ch] == WS28XX_GammaTable[BENCH_Rgb[(i * WS28XX_COLOR_CHANNEL) + ch]]);
+#else
+			same &= (hLed.Pixel[i].Color[ch] == BENCH_Rgb[(i * WS28XX_COLOR_CHANNEL) + ch]);
+#endif
+		}
+	}
+	//@info a range past the end is refused without writing anything
+	memcpy(BENCH_Saved, hLed.Pixel, size);
+	same &= (WS28XX_FillPixel_RGB(&hLed, count - 1, 2, 1, 2, 3) == false);
+	same &= (WS28XX_CopyPixel_RGB_888(&hLed, 1, count, BENCH_Rgb) == false);
+	same &= (WS28XX_SetRangePixel_Brightness(&hLed, 0, 0, 1) == false);
+	same &= (memcmp(BENCH_Saved, hLed.Pixel, size) == 0);
+	return same;
+}
+#endif
+
+/***********************************************************************************************************/
+
+typedef struct {
+	const char       *Name;
+	BENCH_FuncTypeDef Func;
+	uint8_t           Brightness;
+} BENCH_CaseTypeDef;
+
+static const BENCH_CaseTypeDef BENCH_Case[] = {
+    {"WS28XX_Update",                   BENCH_Update,                   0  },
+    {"WS28XX_Update(scaled)",           BENCH_Update,                   100},
+    {"WS28XX_Update(1 dirty)",          BENCH_Update_OneDirty,          0  },
+    {"WS28XX_Update(clean)",            BENCH_Update_Clean,             0  },
+#if (WS28XX_FRAMEBUFFER == false)
+    {"scale(division)",                 BENCH_Scale_Division,           100},
+    {"scale(reciprocal)",               BENCH_Scale_Reciprocal,         100},
+    {"WS28XX_SetPixel_RGB",             BENCH_SetPixel_RGB,             0  },
+    {"WS28XX_SetPixel_RGB_565",         BENCH_SetPixel_RGB_565,         0  },
+    {"WS28XX_SetPixel_RGB_888",         BENCH_SetPixel_RGB_888,         0  },
+    {"WS28XX_SetPixel_RGBW",            BENCH_SetPixel_RGBW,            0  },
+    {"WS28XX_SetPixel_RGBW_565",        BENCH_SetPixel_RGBW_565,        0  },
+    {"WS28XX_SetPixel_RGBW_888",        BENCH_SetPixel_RGBW_888,        0  },
+#endif
+    {"WS28XX_SetAllPixel_Brightness",   BENCH_SetAllPixel_Brightness,   0  },
+#if (WS28XX_FRAMEBUFFER == false)
+    {"WS28XX_SetOnePixel_Brightness",   BENCH_SetOnePixel_Brightness,   0  },
+    {"SetPixel_RGB(same color)",        BENCH_SetPixel_RGB_Fill,        0  },
+    {"WS28XX_FillPixel_RGB",            BENCH_FillPixel_RGB,            0  },
+    {"SetPixel_RGB(image)",             BENCH_SetPixel_RGB_Image,       0  },
+    {"WS28XX_CopyPixel_RGB_888",        BENCH_CopyPixel_RGB_888,        0  },
+    {"SetPixel_RGB_565(image)",         BENCH_SetPixel_RGB_565_Image,   0  },
+    {"WS28XX_CopyPixel_RGB_565",        BENCH_CopyPixel_RGB_565,        0  },
+    {"WS28XX_CopyPixel_Raw",            BENCH_CopyPixel_Raw,            0  },
+    {"WS28XX_SetRangePixel_Brightness", BENCH_SetRangePixel_Brightness, 0  },
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+    {"transpose(bit loop)",             BENCH_Transpose_Loop,           0  },
+    {"transpose(SWAR)",                 BENCH_Transpose_Swar,           0  },
+#endif
+};
+
+/***********************************************************************************************************/
+
+static const char *const BENCH_ChipName[] = {"conf", "WS2811", "WS2812", "WS2812B", "WS2815", "SK6812"};
+
+static const char *BENCH_OrderName(void) {
+#if WS28XX_ORDER == WS28XX_ORDER_RGB
+	return "RGB";
+#elif WS28XX_ORDER == WS28XX_ORDER_BGR
+	return "BGR";
+#elif WS28XX_ORDER == WS28XX_ORDER_GRB
+	return "GRB";
+#endif
+}
+
+/***********************************************************************************************************/
+
+static void BENCH_Prepare(uint16_t Pixel, uint8_t Brightness) {
+#if (WS28XX_EXTERNAL_BUFFER == true)
+#	if (WS28XX_FRAMEBUFFER == true)
+	WS28XX_SetBuffer(&hLed, NULL, BENCH_Pulse, Pixel);
+#	else
+	WS28XX_SetBuffer(&hLed, BENCH_Pixel, BENCH_Pulse, Pixel);
+#	endif
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+	WS28XX_Init_Multi(&hLed, &hTim, BENCH_TIMER_MHZ, WS28XX_MULTI_CHANNEL, Pixel / WS28XX_MULTI_CHANNEL);
+#elif (WS28XX_SPI_SYMBOL > 0)
+	WS28XX_Init_Spi(&hLed, &hSpi, Pixel);
+#elif (WS28XX_GPIO_LANE > 0)
+	WS28XX_Init_Gpio(&hLed, &hTim, BENCH_TIMER_MHZ, &hGpio, (Pixel + WS28XX_GPIO_LANE - 1) / WS28XX_GPIO_LANE);
+#else
+	WS28XX_Init(&hLed, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, Pixel);
+#endif
+	HOST_TIM_Run(); //@info Let the reset frame sent by WS28XX_Init finish
+	BENCH_Fill(Pixel);
+	if (Brightness != 0) {
+		WS28XX_SetAllPixel_Brightness(&hLed, Brightness);
+	}
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_INGEST == true)
+//@info BENCH_INGEST_FRAME Adalight frames of Pixel LEDs into BENCH_Stream and the pixels each one must leave in
+//      BENCH_IngestPixel. With Noise, junk and a header with a wrong checksum come before every frame, and two
+//      frames have fewer and more LEDs than the strip. Returns the length of the stream
+static uint32_t BENCH_IngestBuild(uint16_t Pixel, bool Noise) {
+	static const uint8_t junk[] = {0x00, 'A', 'A', 'd', 'A', 'd', 'x', 0xFF, 'A', 'd', 'a', 0x01, 0x00, 0x55}; //@info Last 6 bytes: wrong checksum
+	uint8_t *stream = BENCH_Stream;
+	BENCH_Prepare(Pixel, 0);
+	for (uint32_t f = 0; f < BENCH_INGEST_FRAME; f++) {
+		uint32_t count = Pixel;
+		if (Noise) {
+			memcpy(stream, junk, sizeof(junk));
+			stream += sizeof(junk);
+			count = (f == 2) ? Pixel / 2 : ((f == 3) ? Pixel + 5 : Pixel);
+		}
+		stream[0] = 'A';
+		stream[1] = 'd';
+		stream[2] = 'a';
+		stream[3] = (uint8_t)((count - 1) >> 8);
+		stream[4] = (uint8_t)(count - 1);
+		stream[5] = stream[3] ^ stream[4] ^ 0x55;
+		stream += 6;
+		for (uint32_t i = 0; i < count * 3; i++) {
+			stream[i] = (uint8_t)BENCH_Color((f * 7919) + i);
+		}
+		WS28XX_CopyPixel_RGB_888(&hLed, 0, (count < Pixel) ? count : Pixel, stream);
+		memcpy(BENCH_IngestPixel[f], hLed.Pixel, Pixel * sizeof(WS28XX_PixelTypeDef));
+		stream += count * 3;
+	}
+	return (uint32_t)(stream - BENCH_Stream);
+}
+
+/***********************************************************************************************************/
+
+//@info Frames from a file, "-" for stdin, or the test stream written to a file with "-w FILE"
+static int BENCH_IngestFile(int argc, char **argv) {
+	static uint8_t piece[4096];
+	FILE          *file;
+	uint64_t       bytes = 0, elapsed = 0;
+	uint32_t       frame = 0;
+	size_t         length;
+	if ((strcmp(argv[1], "-w") == 0) && (argc > 2)) {
+		length = BENCH_IngestBuild(WS28XX_PIXEL_MAX, true);
+		file   = fopen(argv[2], "wb");
+		if ((file == NULL) || (fwrite(BENCH_Stream, 1, length, file) != length)) {
+			printf("# cannot write %s\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+		fclose(file);
+		printf("# %zu bytes, %d frames of %d LEDs written to %s\n", length, BENCH_INGEST_FRAME, WS28XX_PIXEL_MAX, argv[2]);
+		return EXIT_SUCCESS;
+	}
+	file = (strcmp(argv[1], "-") == 0) ? stdin : fopen(argv[1], "rb");
+	if (file == NULL) {
+		printf("# cannot read %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+	while ((length = fread(piece, 1, sizeof(piece), file)) > 0) {
+		uint64_t start = BENCH_Now();
+		frame += WS28XX_Ingest(&hLed, piece, (uint32_t)length);
+		elapsed += BENCH_Now() - start;
+		bytes += length;
+	}
+	if (file != stdin) {
+		fclose(file);
+	}
+	printf("# ingest %s: %llu bytes, %u frames, %u bad headers, %.1f MB/s with the updates\n", argv[1], (unsigned long long)bytes, (unsigned)frame,
+	       (unsigned)hLed.Ingest_Error, (elapsed == 0) ? 0.0 : (bytes * 1000.0) / elapsed);
+	return EXIT_SUCCESS;
+}
+#endif
+
+/***********************************************************************************************************/
+
+int main(int argc, char **argv) {
+	printf("# order=%s gamma=%d stream=%d lut=%d double=%d multi=%d gpio=%d spi=%d channel=%d white=%d byte=%d stats=%d sched=%d queue=%d matrix=%d ingest=%d pixel_max=%d handle=%zu bytes\n", BENCH_OrderName(), WS28XX_GAMMA, WS28XX_STREAM, WS28XX_COLOR_LUT, WS28XX_DOUBLE_BUFFER, WS28XX_MULTI_CHANNEL, WS28XX_GPIO_LANE, WS28XX_SPI_SYMBOL, WS28XX_COLOR_CHANNEL, WS28XX_WHITE_EXTRACT, WS28XX_BYTE_PULSE, WS28XX_STATS, WS28XX_SCHEDULER, WS28XX_QUEUE, WS28XX_MATRIX, WS28XX_INGEST, WS28XX_PIXEL_MAX, sizeof(WS28XX_HandleTypeDef));
+#if (WS28XX_FRAMEBUFFER == true)
+	printf("# pixel storage=0 bytes/pixel (framebuffer), pulse buffer=%zu bytes, external=%d\n", WS28XX_PULSE_BUFFER(WS28XX_PIXEL_MAX) * sizeof(WS28XX_SlotTypeDef),
+	       WS28XX_EXTERNAL_BUFFER);
+#else
+	printf("# pixel storage=%zu bytes/pixel, pulse buffer=%zu bytes, external=%d\n", sizeof(hLed.Pixel[0]), WS28XX_PULSE_BUFFER(WS28XX_PIXEL_MAX) * sizeof(WS28XX_SlotTypeDef),
+	       WS28XX_EXTERNAL_BUFFER);
+#endif
+#if (WS28XX_INGEST == true)
+	if (argc > 1) {
+		return BENCH_IngestFile(argc, argv);
+	}
+#else
+	(void)argc;
+	(void)argv;
+#endif
+
+	// Frame hash of a fixed pattern, compare between builds to prove byte-identical encoder output
+	for (uint8_t b = 0; b < 2; b++) {
+		BENCH_Prepare(WS28XX_PIXEL_MAX, b ? 100 : 0);
+		BENCH_Send(true);
+		printf("# frame hash (brightness %3d): %08X\n", b ? 100 : 0, (unsigned)BENCH_Hash(BENCH_Log, HOST_TIM_Capture.Log_Length));
+	}
+#if (WS28XX_GAMMA == false)
+	BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+	BENCH_Send(true);
+	if (BENCH_VerifyFrame(0) == false) {
+		printf("# decoded frame does not match the pixels\n");
+		return EXIT_FAILURE;
+	}
+	printf("# decoded frame matches the pixels\n");
+#endif
+#if (WS28XX_SPI_SYMBOL > 0)
+	{
+		// MOSI must stay low for the latch time after the last bit before the transfer completes
+		uint32_t low = 0;
+		while ((low < HOST_TIM_Capture.Log_Length) && (BENCH_Log[HOST_TIM_Capture.Log_Length - 1 - low] == 0)) {
+			low++;
+		}
+		printf("# spi: frame ends with %.0f us low\n", (low * 8.0 * WS28XX_PULSE_LENGTH_NS) / (WS28XX_SPI_SYMBOL * 1000.0));
+		if ((low * 8ULL * WS28XX_PULSE_LENGTH_NS) < ((uint64_t)WS28XX_RESET_NS * WS28XX_SPI_SYMBOL)) {
+			printf("# spi frame does not end with the latch time\n");
+			return EXIT_FAILURE;
+		}
+	}
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+	printf("# gpio: %d lanes x %u pixels, frame on the wire %.0f us, SWAR transpose %s the bit loop\n", WS28XX_GPIO_LANE, hLed.Strip_Pixel,
+	       ((uint32_t)hLed.Strip_Pixel * WS28XX_PIXEL_SLOT * WS28XX_PULSE_LENGTH_NS) / 1000.0, BENCH_TransposeCheck() ? "matches" : "DIFFERS FROM");
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+	// All strips share the wire time of one, a single channel would send the same pixels one after another
+	printf("# multi: %d strips, frame on the wire %.0f us, %.0f us on one channel\n", WS28XX_MULTI_CHANNEL,
+	       ((HOST_TIM_Capture.Length / HOST_TIM_Capture.Burst) * WS28XX_PULSE_LENGTH_NS) / 1000.0, (((hLed.Num_Pixel * WS28XX_PIXEL_SLOT) + 1 + hLed.Reset_Slot) * WS28XX_PULSE_LENGTH_NS) / 1000.0);
+#endif
+	for (uint32_t i = 0; i < sizeof(BENCH_Rgb); i++) {
+		BENCH_Rgb[i] = (uint8_t)BENCH_Color(i);
+	}
+#if (WS28XX_FRAMEBUFFER == true)
+	// The same image drawn in every byte order must give the frame of the RGB one
+	{
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		BENCH_Send(true);
+		uint32_t hash = BENCH_Hash(BENCH_Log, HOST_TIM_Capture.Log_Length);
+		for (uint8_t order = WS28XX_ORDER_BGR; order <= WS28XX_ORDER_GRB; order++) {
+			for (uint32_t i = 0; i < WS28XX_PIXEL_MAX; i++) {
+				uint8_t rgb[3] = {(uint8_t)(BENCH_Color(i) >> 16), (uint8_t)(BENCH_Color(i) >> 8), (uint8_t)BENCH_Color(i)};
+				for (uint8_t c = 0; c < 3; c++) {
+					BENCH_Frame[(i * BENCH_FRAME_BYTES) + BENCH_OrderIndex[order][c]] = rgb[c];
+				}
+			}
+			WS28XX_SetFrameBuffer(&hLed, BENCH_Frame, (WS28XX_COLOR_CHANNEL == 4) ? WS28XX_FORMAT_8888 : WS28XX_FORMAT_888, order);
+			BENCH_Send(true);
+			if (BENCH_Hash(BENCH_Log, HOST_TIM_Capture.Log_Length) != hash) {
+				printf("# framebuffer in order %u differs from the RGB one\n", order);
+				return EXIT_FAILURE;
+			}
+		}
+		printf("# framebuffer orders match\n");
+	}
+#else
+	// Bulk setters against the per-pixel calls they replace, on the same source image
+	for (uint32_t i = 0; i < WS28XX_PIXEL_MAX; i++) {
+		uint32_t color = BENCH_Color(i);
+		BENCH_Rgb[(i * 3) + 0] = (uint8_t)(color >> 16);
+		BENCH_Rgb[(i * 3) + 1] = (uint8_t)(color >> 8);
+		BENCH_Rgb[(i * 3) + 2] = (uint8_t)color;
+		BENCH_Rgb565[i]        = (uint16_t)(color * 40503U);
+	}
+	BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+	if (BENCH_BulkCheck() == false) {
+		printf("# bulk setters differ from the per-pixel ones\n");
+		return EXIT_FAILURE;
+	}
+	printf("# bulk setters match the per-pixel ones\n");
+#endif
+#if (WS28XX_MATRIX == true)
+	// Every wiring and rotation of a 32 x 16 matrix of 8 x 8 tiles against a walk along the strip
+	{
+		WS28XX_MatrixTypeDef matrix = {.Width = 32, .Height = 16, .Tile_Width = 8, .Tile_Height = 8};
+		const size_t         size   = WS28XX_PIXEL_MAX * sizeof(WS28XX_PixelTypeDef);
+		bool                 same   = true;
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		for (matrix.Rotate = WS28XX_ROTATE_0; matrix.Rotate <= WS28XX_ROTATE_270; matrix.Rotate++) {
+			for (matrix.Layout = WS28XX_LAYOUT_ROW; matrix.Layout <= WS28XX_LAYOUT_COLUMN_SERPENTINE; matrix.Layout++) {
+				for (matrix.Tile_Layout = WS28XX_LAYOUT_ROW; matrix.Tile_Layout <= WS28XX_LAYOUT_COLUMN_SERPENTINE; matrix.Tile_Layout++) {
+					same &= WS28XX_SetMatrix(&hLed, BENCH_Map, &matrix) && BENCH_MatrixCheck(&matrix);
+				}
+			}
+		}
+		//@info the last one is rotated by 270, 16 columns and 32 rows. Blit and fills hang over its edges
+		memcpy(BENCH_Saved, hLed.Pixel, size);
+		same &= WS28XX_Matrix_Blit_RGB_888(&hLed, -3, 25, 20, 12, BENCH_Rgb);
+		same &= WS28XX_Matrix_FillRect_RGB(&hLed, 10, -2, 9, 5, 0x12, 0x34, 0x56);
+		same &= WS28XX_Matrix_FillSpan_RGB(&hLed, -4, 31, 40, 0x12, 0x34, 0x56);
+		memcpy(BENCH_Drawn, hLed.Pixel, size);
+		memcpy(hLed.Pixel, BENCH_Saved, size);
+		BENCH_MatrixDraw(-3, 25, 20, 12, BENCH_Rgb);
+		BENCH_MatrixDraw(10, -2, 9, 5, NULL);
+		BENCH_MatrixDraw(-4, 31, 40, 1, NULL);
+		same &= (memcmp(BENCH_Drawn, hLed.Pixel, size) == 0);
+		//@info nothing on the matrix, nothing written
+		same &= (WS28XX_Matrix_FillRect_RGB(&hLed, 16, 0, 4, 4, 1, 2, 3) == false);
+		same &= (WS28XX_Matrix_Blit_RGB_888(&hLed, -20, 0, 20, 12, BENCH_Rgb) == false);
+		same &= (WS28XX_Matrix_SetPixel_RGB(&hLed, 0, 32, 1, 2, 3) == false);
+		same &= (memcmp(BENCH_Drawn, hLed.Pixel, size) == 0);
+		matrix.Width = 33;
+		same &= (WS28XX_SetMatrix(&hLed, BENCH_Map, &matrix) == false);
+		if (same == false) {
+			printf("# matrix map or drawing differs from the walk along the strip\n");
+			return EXIT_FAILURE;
+		}
+		matrix = (WS28XX_MatrixTypeDef) {.Width = BENCH_MATRIX_SIDE, .Height = BENCH_MATRIX_SIDE, .Tile_Width = 8, .Tile_Height = 8,
+		                                 .Layout = WS28XX_LAYOUT_SERPENTINE, .Tile_Layout = WS28XX_LAYOUT_SERPENTINE};
+		WS28XX_SetMatrix(&hLed, BENCH_Map, &matrix);
+		BENCH_Matrix_Arithmetic(0);
+		memcpy(BENCH_Saved, hLed.Pixel, size);
+		BENCH_Matrix_Blit_RGB_888(0);
+		if (memcmp(BENCH_Saved, hLed.Pixel, size) != 0) {
+			printf("# matrix blit differs from the index math\n");
+			return EXIT_FAILURE;
+		}
+		printf("# matrix %dx%d of serpentine 8x8 tiles [ns/pixel]: index math + SetPixel_RGB %.2f, Matrix_SetPixel_RGB %.2f, Matrix_Blit_RGB_888 %.2f, Matrix_FillRect_RGB %.2f\n",
+		       BENCH_MATRIX_SIDE, BENCH_MATRIX_SIDE, BENCH_Run(BENCH_Matrix_Arithmetic, BENCH_MATRIX_SIDE * BENCH_MATRIX_SIDE),
+		       BENCH_Run(BENCH_Matrix_SetPixel_RGB, BENCH_MATRIX_SIDE * BENCH_MATRIX_SIDE), BENCH_Run(BENCH_Matrix_Blit_RGB_888, BENCH_MATRIX_SIDE * BENCH_MATRIX_SIDE),
+		       BENCH_Run(BENCH_Matrix_FillRect_RGB, BENCH_MATRIX_SIDE * BENCH_MATRIX_SIDE));
+	}
+#endif
+#if (WS28XX_INGEST == true)
+	// Adalight frames byte by byte and in random pieces through a DMA ring, each one must leave the pixels
+	// WS28XX_CopyPixel_RGB_888 leaves and be sent once
+	{
+		static uint8_t ring[BENCH_INGEST_RING];
+		const size_t   size   = WS28XX_PIXEL_MAX * sizeof(WS28XX_PixelTypeDef);
+		uint32_t       length = BENCH_IngestBuild(WS28XX_PIXEL_MAX, true);
+		uint32_t       frame  = 0;
+		uint32_t       sent;
+		bool           same   = true;
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		for (uint32_t i = 0; i < length; i++) {
+			if (WS28XX_Ingest(&hLed, &BENCH_Stream[i], 1) > 0) {
+				same &= (frame < BENCH_INGEST_FRAME) && (memcmp(BENCH_IngestPixel[frame], hLed.Pixel, size) == 0);
+				frame++;
+			}
+		}
+		same &= (frame == BENCH_INGEST_FRAME) && (hLed.Ingest_Frame == frame) && (hLed.Ingest_Error == BENCH_INGEST_FRAME);
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		sent  = HOST_TIM_Capture.Count;
+		frame = 0;
+		for (uint32_t i = 0, head = 0, seed = 1; i < length;) {
+			//@info the DMA may write up to the ring size - 1 bytes between two calls
+			uint32_t piece = 1 + ((seed >> 16) % (BENCH_INGEST_RING - 1));
+			seed           = (seed * 1103515245U) + 12345U;
+			piece          = (piece > (length - i)) ? (length - i) : piece;
+			for (uint32_t k = 0; k < piece; k++) {
+				ring[(head + k) % BENCH_INGEST_RING] = BENCH_Stream[i + k];
+			}
+			head = (head + piece) % BENCH_INGEST_RING;
+			frame += WS28XX_Ingest_Ring(&hLed, ring, BENCH_INGEST_RING, (head == 0) ? BENCH_INGEST_RING : head);
+			i += piece;
+		}
+		same &= (frame == BENCH_INGEST_FRAME) && (HOST_TIM_Capture.Count - sent == BENCH_INGEST_FRAME);
+		same &= (memcmp(BENCH_IngestPixel[BENCH_INGEST_FRAME - 1], hLed.Pixel, size) == 0);
+#	if (WS28XX_GAMMA == false)
+		//@info the transfer the last frame started carries it
+		HOST_TIM_Capture.Log        = BENCH_Log;
+		HOST_TIM_Capture.Log_Size   = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+		HOST_TIM_Capture.Log_Length = 0;
+		HOST_TIM_Run();
+		same &= BENCH_VerifyFrame(0);
+#	endif
+#	if (WS28XX_SCHEDULER == true)
+		//@info while the scheduler runs the frames are only stored, the next due tick sends the last one
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		same &= WS28XX_SetFrameRate(&hLed, 10, 1000);
+		sent = HOST_TIM_Capture.Count;
+		same &= (WS28XX_Ingest(&hLed, BENCH_Stream, length) == BENCH_INGEST_FRAME) && (HOST_TIM_Capture.Count == sent);
+		for (uint16_t tick = 0; tick < 1000 / 10; tick++) {
+			WS28XX_Tick(&hLed);
+		}
+		same &= (HOST_TIM_Capture.Count - sent == 1) && (memcmp(BENCH_IngestPixel[BENCH_INGEST_FRAME - 1], hLed.Pixel, size) == 0);
+		HOST_TIM_Run();
+		WS28XX_SetFrameRate(&hLed, 0, 1000);
+#	endif
+		if (same == false) {
+			printf("# ingested frames differ from the stream\n");
+			return EXIT_FAILURE;
+		}
+		printf("# ingest: %u frames, %u bad headers skipped, byte by byte and through a %u byte ring\n", BENCH_INGEST_FRAME, BENCH_INGEST_FRAME, BENCH_INGEST_RING);
+		BENCH_StreamLength = BENCH_IngestBuild(WS28XX_PIXEL_MAX, false) / BENCH_INGEST_FRAME;
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		double ingest = BENCH_Run(BENCH_Ingest, WS28XX_PIXEL_MAX);
+		double update = BENCH_Run(BENCH_Ingest_Update, WS28XX_PIXEL_MAX);
+		printf("# ingest %d LEDs [ns/pixel]: Ingest %.2f, in %d byte pieces %.2f, byte by byte %.2f, whole frame + SetPixel_RGB %.2f, of which WS28XX_Update %.2f\n",
+		       WS28XX_PIXEL_MAX, ingest, BENCH_INGEST_PIECE, BENCH_Run(BENCH_Ingest_Piece, WS28XX_PIXEL_MAX), BENCH_Run(BENCH_Ingest_Byte, WS28XX_PIXEL_MAX),
+		       BENCH_Run(BENCH_Ingest_SetPixel, WS28XX_PIXEL_MAX), update);
+		printf("# ingest: %.0f MB/s with the update, %.0f MB/s parsing and storing\n", 3000.0 / ingest, 3000.0 / (ingest - update));
+	}
+#endif
+#if (WS28XX_BYTE_PULSE == true)
+	// Prescaler the byte slots need at common timer clocks, and the pulses it leaves
+	{
+		static const uint16_t mhz[] = {72, 84, 170, 216, 275, 480};
+		for (uint8_t i = 0; i < sizeof(mhz) / sizeof(mhz[0]); i++) {
+			bool ok = WS28XX_Init(&hLed, &hTim, mhz[i], TIM_CHANNEL_1, 8);
+			HOST_TIM_Run();
+			printf("# byte pulse at %3u MHz: %s, psc %u, arr %3u, pulse0 %3.0f ns, pulse1 %3.0f ns\n", mhz[i], ok ? "ok" : "FAILED", (unsigned)hTimInstance.PSC,
+			       (unsigned)__HAL_TIM_GET_AUTORELOAD(&hTim), (hLed.Pulse0 * (hTimInstance.PSC + 1) * 1000.0) / mhz[i], (hLed.Pulse1 * (hTimInstance.PSC + 1) * 1000.0) / mhz[i]);
+			if (ok == false) {
+				return EXIT_FAILURE;
+			}
+		}
+	}
+#endif
+	// Timer setup of every chip profile, each one at its own bit rate and latch time
+	for (uint8_t chip = WS28XX_CHIP_WS2811; chip <= WS28XX_CHIP_SK6812; chip++) {
+		WS28XX_Init_Chip(&hLed, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, 8, (WS28XX_ChipTypeDef)chip);
+		HOST_TIM_Run();
+		printf("# chip %-7s: arr %3u, pulse0 %2u, pulse1 %3u, latch %3u slots\n", BENCH_ChipName[chip], (unsigned)__HAL_TIM_GET_AUTORELOAD(&hTim), hLed.Pulse0,
+		       hLed.Pulse1, hLed.Reset_Slot);
+	}
+	BENCH_ScaleAccuracy();
+#if (WS28XX_COLOR_LUT == true)
+	{
+		uint64_t start = BENCH_Now();
+		WS28XX_SetGamma(&hLed, 2.2f);
+		WS28XX_SetGlobalBrightness(&hLed, 128);
+		WS28XX_SetColorCorrection(&hLed, 255, 224, 176);
+		BENCH_Send(false);
+		printf("# color LUT rebuild + full frame: %.1f us\n", (BENCH_Now() - start) / 1000.0);
+	}
+#endif
+#if (WS28XX_EXTERNAL_BUFFER == true) && (WS28XX_GAMMA == false)
+	{
+		// A status strip of 10 pixels in buffers of its own size, next to the WS28XX_PIXEL_MAX ones
+		static WS28XX_SlotTypeDef  pulse[WS28XX_PULSE_BUFFER(10)];
+#	if (WS28XX_FRAMEBUFFER == true)
+		static const size_t        pixel = 0; //@info The pixels are read from BENCH_Frame
+		WS28XX_SetBuffer(&hLed, NULL, pulse, 10);
+#	else
+		static WS28XX_PixelTypeDef pixel[10];
+		WS28XX_SetBuffer(&hLed, pixel, pulse, 10);
+#	endif
+		if (WS28XX_Init(&hLed, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, 11) == true) {
+			printf("# external buffer accepted more pixels than it holds\n");
+			return EXIT_FAILURE;
+		}
+		WS28XX_Init(&hLed, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, 10);
+		HOST_TIM_Run();
+		BENCH_Fill(10);
+		BENCH_Send(true);
+#	if (WS28XX_FRAMEBUFFER == true)
+		printf("# external buffer: 10 pixels in %zu + %zu bytes\n", pixel, sizeof(pulse));
+#	else
+		printf("# external buffer: 10 pixels in %zu + %zu bytes\n", sizeof(pixel), sizeof(pulse));
+#	endif
+		if (BENCH_VerifyFrame(0) == false) {
+			printf("# decoded frame does not match the pixels\n");
+			return EXIT_FAILURE;
+		}
+	}
+#endif
+#if (WS28XX_DOUBLE_BUFFER == true)
+	// A refused first frame must fail the init, its callback would never clear Busy
+	HOST_TIM_Reset();
+	HOST_TIM_Capture.Busy    = true;
+	HOST_TIM_Capture.Running = true;
+	if (WS28XX_Init(&hLed, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, WS28XX_PIXEL_MAX) == true) {
+		printf("# init passed although its first frame was not sent\n");
+		return EXIT_FAILURE;
+	}
+	HOST_TIM_Reset();
+#endif
+#if (WS28XX_DOUBLE_BUFFER == true) && (WS28XX_GAMMA == false)
+	// Second update while the first frame is on the wire, it must be queued and sent right after
+	BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+	HOST_TIM_Reset();
+	HOST_TIM_Capture.Log      = BENCH_Log;
+	HOST_TIM_Capture.Log_Size = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+	BENCH_Frames              = 0;
+	WS28XX_Update(&hLed);
+#	if (WS28XX_FRAMEBUFFER == true)
+	BENCH_Frame[0] = 0x12;
+	BENCH_Frame[1] = 0x34;
+	BENCH_Frame[2] = 0x56;
+	WS28XX_RefreshRange(&hLed, 0, 1);
+#	else
+	WS28XX_SetPixel_RGB_888(&hLed, 0, 0x123456);
+#	endif
+	WS28XX_Update(&hLed);
+	HOST_TIM_Run();
+	{
+		// The queued frame must follow the latch time of the chip, not the last pulse of the first frame
+		uint32_t frame = (WS28XX_PIXEL_MAX * WS28XX_PIXEL_SLOT) + 1;
+		uint32_t gap   = 0;
+		while ((frame + gap < HOST_TIM_Capture.Log_Length) && (BENCH_Log[frame + gap] == 0)) {
+			gap++;
+		}
+		printf("# double buffer: %u frames sent for two overlapped updates, %u low slots between them\n", (unsigned)BENCH_Frames, (unsigned)gap);
+		if ((BENCH_Frames != 2) || (gap < hLed.Reset_Slot) || (BENCH_VerifyFrame(frame + hLed.Reset_Slot) == false)) {
+			printf("# queued frame does not match the pixels\n");
+			return EXIT_FAILURE;
+		}
+	}
+#endif
+#if (WS28XX_STREAM == false) && (WS28XX_DOUBLE_BUFFER == false) && (WS28XX_GAMMA == false)
+	// An update refused with HAL_BUSY while the last frame is on the wire must leave its pixels for the next one
+	BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+	BENCH_Send(false);
+	HOST_TIM_Reset();
+	HOST_TIM_Capture.Busy = true;
+	WS28XX_Refresh(&hLed);
+	WS28XX_Update(&hLed);
+#	if (WS28XX_FRAMEBUFFER == true)
+	BENCH_Frame[0] = 0x12;
+	BENCH_Frame[1] = 0x34;
+	BENCH_Frame[2] = 0x56;
+	WS28XX_RefreshRange(&hLed, 0, 1);
+#	else
+	WS28XX_SetPixel_RGB_888(&hLed, 0, 0x123456);
+#	endif
+	if (WS28XX_Update(&hLed) == true) {
+		printf("# update was not refused while the last frame is on the wire\n");
+		return EXIT_FAILURE;
+	}
+	HOST_TIM_Run();
+	HOST_TIM_Capture.Log        = BENCH_Log;
+	HOST_TIM_Capture.Log_Size   = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+	HOST_TIM_Capture.Log_Length = 0;
+	WS28XX_Update(&hLed);
+	HOST_TIM_Run();
+	if (BENCH_VerifyFrame(0) == false) {
+		printf("# pixels of a refused update were not sent by the next one\n");
+		return EXIT_FAILURE;
+	}
+	printf("# busy: refused update is sent by the next one\n");
+#endif
+#if (WS28XX_STREAM == false) && (WS28XX_DOUBLE_BUFFER == false) && (WS28XX_SPI_SYMBOL == 0) && (WS28XX_GAMMA == false)
+	// Two plain updates back to back, the second frame must follow the latch time of the chip like the queued one
+	{
+		uint32_t next;
+		uint32_t gap;
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		HOST_TIM_Reset();
+		HOST_TIM_Capture.Log      = BENCH_Log;
+		HOST_TIM_Capture.Log_Size = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+		WS28XX_Update(&hLed);
+		HOST_TIM_Run();
+		WS28XX_Refresh(&hLed);
+		WS28XX_Update(&hLed);
+		HOST_TIM_Run();
+		gap = BENCH_LatchGap(&next);
+		printf("# latch: %u low slots between two plain updates, %u needed\n", (unsigned)gap, (unsigned)hLed.Reset_Slot);
+		if ((gap < hLed.Reset_Slot) || (BENCH_VerifyFrame(next) == false)) {
+			printf("# second frame does not follow the latch time\n");
+			return EXIT_FAILURE;
+		}
+	}
+#endif
+#if (WS28XX_STREAM == true)
+	HOST_TIM_Reset();
+	HOST_TIM_Capture.Late = true;
+	WS28XX_Update(&hLed);
+	HOST_TIM_Run();
+	printf("# stream window=%d pixels, underruns in a late frame: %u\n", WS28XX_STREAM_PIXEL, (unsigned)hLed.Stream_Underrun);
+#endif
+
+#if (WS28XX_QUEUE > 0)
+	// Producer threads post into the ring while this thread keeps updating, the result must equal the setters
+	{
+		pthread_t thread[BENCH_PRODUCER];
+		uint32_t  update = 0;
+		uint64_t  start;
+		double    seconds;
+		BENCH_Prepare(BENCH_PRODUCER * BENCH_PRODUCER_PIXEL, 0);
+		memset(&hRef, 0, sizeof(hRef));
+#	if (WS28XX_EXTERNAL_BUFFER == true)
+		hRef.Pixel = BENCH_RefPixel;
+#	endif
+		hRef.Num_Pixel = hLed.Num_Pixel;
+		memcpy(hRef.Pixel, hLed.Pixel, hLed.Num_Pixel * sizeof(WS28XX_PixelTypeDef));
+		atomic_store(&BENCH_Producing, BENCH_PRODUCER);
+		start = BENCH_Now();
+		for (uintptr_t p = 0; p < BENCH_PRODUCER; p++) {
+			pthread_create(&thread[p], NULL, BENCH_Producer, (void *)p);
+		}
+		while (atomic_load(&BENCH_Producing) != 0) {
+			BENCH_Send(false);
+			update++;
+			sched_yield(); //@info Hand the core to the producers, the host may have a single one
+		}
+		for (uint8_t p = 0; p < BENCH_PRODUCER; p++) {
+			pthread_join(thread[p], NULL);
+		}
+		BENCH_Send(true);
+		seconds = (BENCH_Now() - start) / 1e9;
+		for (uint8_t p = 0; p < BENCH_PRODUCER; p++) {
+			for (uint32_t i = 0; i < BENCH_PRODUCER_POST; i++) {
+				BENCH_Command(p, i, false);
+			}
+		}
+		printf("# queue: %d producers, %u commands in %.2f s (%.1f M/s) over %u updates, %u posts found the ring of %d full\n", BENCH_PRODUCER,
+		       BENCH_PRODUCER * BENCH_PRODUCER_POST, seconds, (BENCH_PRODUCER * BENCH_PRODUCER_POST) / seconds / 1e6, (unsigned)update,
+		       (unsigned)hLed.Queue_Full, WS28XX_QUEUE);
+		if ((hLed.Queue_Tail != BENCH_PRODUCER * BENCH_PRODUCER_POST) || (memcmp(hLed.Pixel, hRef.Pixel, hLed.Num_Pixel * sizeof(WS28XX_PixelTypeDef)) != 0)) {
+			printf("# queued commands differ from the setters\n");
+			return EXIT_FAILURE;
+		}
+#	if (WS28XX_GAMMA == false)
+		if (BENCH_VerifyFrame(0) == false) {
+			printf("# decoded frame does not match the pixels\n");
+			return EXIT_FAILURE;
+		}
+#	endif
+	}
+#endif
+#if (WS28XX_SCHEDULER == true)
+	// One second of 1 kHz ticks at 100 fps, with several changes per tick that must end up in one frame each
+	{
+		uint16_t max;
+		uint32_t started = 0;
+		uint32_t next;
+		uint32_t gap;
+		BENCH_Prepare(256, 0);
+		max = WS28XX_MaxFrameRate(&hLed);
+		//@info max fps at almost twice the tick rate puts some frames one tick apart, shorter than a frame
+		if ((WS28XX_SetFrameRate(&hLed, max + 1, 100000) == true) || (WS28XX_SetFrameRate(&hLed, 100, 99) == true) ||
+		    (WS28XX_SetFrameRate(&hLed, max, (2 * max) - 1) == true) || (WS28XX_SetFrameRate(&hLed, max, max) == false) ||
+		    (WS28XX_SetFrameRate(&hLed, 100, 1000) == false)) {
+			printf("# scheduler accepted an impossible rate or refused a possible one\n");
+			return EXIT_FAILURE;
+		}
+		HOST_TIM_Reset();
+		HOST_TIM_Capture.Log      = BENCH_Log;
+		HOST_TIM_Capture.Log_Size = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+		BENCH_Frames              = 0;
+		for (uint32_t tick = 0; tick < 1000; tick++) {
+			for (uint8_t change = 0; change < 3; change++) {
+#	if (WS28XX_FRAMEBUFFER == true)
+				BENCH_Frame[((tick * 3) + change) % 256 * BENCH_FRAME_BYTES] = (uint8_t)BENCH_Color(tick + change);
+				WS28XX_RefreshRange(&hLed, ((tick * 3) + change) % 256, 1);
+#	else
+				WS28XX_SetPixel_RGB_888(&hLed, ((tick * 3) + change) % 256, BENCH_Color(tick + change));
+#	endif
+			}
+			if (WS28XX_Tick(&hLed)) {
+				started++;
+				HOST_TIM_Capture.Log_Length = 0; //@info keep the last frame only
+			}
+			HOST_TIM_Run();
+		}
+		printf("# scheduler: max %u fps for 256 pixels, %u frames started in 1000 ticks at 100 fps\n", max, (unsigned)started);
+		if (started != 100) {
+			printf("# scheduler missed its rate\n");
+			return EXIT_FAILURE;
+		}
+#	if (WS28XX_GAMMA == false)
+		if (BENCH_VerifyFrame(0) == false) {
+			printf("# last scheduled frame does not match the pixels\n");
+			return EXIT_FAILURE;
+		}
+#	endif
+		// A frame due while the last one is on the wire waits for its callback instead of a refused start, and
+		// the callback comes after the latch time so the late frame is not appended to the last one
+		HOST_TIM_Reset();
+		HOST_TIM_Capture.Busy     = true;
+		HOST_TIM_Capture.Log      = BENCH_Log;
+		HOST_TIM_Capture.Log_Size = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+		WS28XX_SetFrameRate(&hLed, 100, 1000);
+		started = 0;
+		for (uint32_t tick = 0; tick < 20; tick++) {
+#	if (WS28XX_FRAMEBUFFER == true)
+			BENCH_Frame[tick * BENCH_FRAME_BYTES] = (uint8_t)BENCH_Color(tick);
+			WS28XX_RefreshRange(&hLed, tick, 1);
+#	else
+			WS28XX_SetPixel_RGB_888(&hLed, tick, BENCH_Color(tick));
+#	endif
+			started += WS28XX_Tick(&hLed);
+		}
+		HOST_TIM_Run();
+		started += WS28XX_Tick(&hLed);
+		HOST_TIM_Run();
+		gap = BENCH_LatchGap(&next);
+		printf("# scheduler: %u frames put off while the wire was busy, %u low slots before the late one\n", (unsigned)hLed.Sched_Late, (unsigned)gap);
+		if ((started != 2) || (hLed.Sched_Late == 0) || (gap < hLed.Reset_Slot)) {
+			printf("# scheduler started a frame while the last one was on the wire\n");
+			return EXIT_FAILURE;
+		}
+#	if (WS28XX_GAMMA == false)
+		if (BENCH_VerifyFrame(next) == false) {
+			printf("# frame put off by the scheduler does not match the pixels\n");
+			return EXIT_FAILURE;
+		}
+#	endif
+		WS28XX_SetFrameRate(&hLed, 0, 1000);
+	}
+#endif
+#if (WS28XX_STATS == true)
+	// Frames back to back for a bit more than one FPS window, then the counters of the handle
+	{
+		WS28XX_StatsTypeDef stats;
+		uint64_t            end;
+		BENCH_Prepare(WS28XX_PIXEL_MAX, 0);
+		WS28XX_ResetStats(&hLed);
+		end = BENCH_Now() + 1100000000ULL;
+		while (BENCH_Now() < end) {
+			WS28XX_Refresh(&hLed);
+			BENCH_Send(false);
+		}
+		WS28XX_GetStats(&hLed, &stats);
+		printf("# stats: %u frames sent, %u done, %u skipped, %.2f fps, lock waited %u times\n", (unsigned)stats.Frame_Sent, (unsigned)stats.Frame_Done,
+		       (unsigned)stats.Frame_Skipped, stats.Fps_Centi / 100.0, (unsigned)stats.Lock_Wait_Count);
+		printf("# stats: encode %u/%u/%u, transfer %u/%u/%u cycles min/avg/max at %u Hz\n", (unsigned)stats.Encode_Min, (unsigned)stats.Encode_Avg,
+		       (unsigned)stats.Encode_Max, (unsigned)stats.Transfer_Min, (unsigned)stats.Transfer_Avg, (unsigned)stats.Transfer_Max, (unsigned)stats.Cycle_Hz);
+		if ((stats.Frame_Sent == 0) || (stats.Frame_Done != stats.Frame_Sent) || (stats.Frame_Skipped != 0) || (stats.Fps_Centi == 0)) {
+			printf("# stats do not add up\n");
+			return EXIT_FAILURE;
+		}
+	}
+#endif
+
+	printf("%-34s", "benchmark [ns/pixel]");
+	for (size_t l = 0; l < sizeof(BENCH_Length) / sizeof(BENCH_Length[0]); l++) {
+		printf("%10u", BENCH_Length[l]);
+	}
+	printf("\n");
+
+	for (size_t c = 0; c < sizeof(BENCH_Case) / sizeof(BENCH_Case[0]); c++) {
+		printf("%-34s", BENCH_Case[c].Name);
+		for (size_t l = 0; l < sizeof(BENCH_Length) / sizeof(BENCH_Length[0]); l++) {
+			BENCH_Prepare(BENCH_Length[l], BENCH_Case[c].Brightness);
+			printf("%10.2f", BENCH_Run(BENCH_Case[c].Func, BENCH_Length[l]));
+			fflush(stdout);
+		}
+		printf("\n");
+	}
+	return EXIT_SUCCESS;
+}
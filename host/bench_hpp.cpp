@@ -0,0 +1,237 @@
+/***********************************************************************************************************
+
+  Host check and benchmark of the C++ front end, ws28xx.hpp.
+
+  Two strips with different color orders run side by side on channel 1 and 2 of one timer. Their decoded
+  frames must carry the colors in their own order, whatever WS28XX_ORDER the library is built with. The
+  template setters are timed against WS28XX_SetPixel_RGB.
+
+***********************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ws28xx.hpp"
+
+/************************************************************************************************************
+**************    Private Definitions
+************************************************************************************************************/
+
+#define BENCH_MIN_NS    20000000ULL
+#define BENCH_TIMER_MHZ 72
+#define BENCH_PIXEL     256
+
+using BENCH_StripA = ws28xx::Strip<ws28xx::Order::RGB>;
+using BENCH_StripB = ws28xx::Strip<ws28xx::Order::BGR>;
+using BENCH_Gamma  = ws28xx::Strip<ws28xx::Order::GRB, 28>;
+using BENCH_Build  = ws28xx::Strip<(ws28xx::Order)WS28XX_ORDER>; //@info Order of the C setters
+
+/************************************************************************************************************
+**************    Private Variables
+************************************************************************************************************/
+
+static WS28XX_HandleTypeDef hLedA;
+static WS28XX_HandleTypeDef hLedB;
+static WS28XX_HandleTypeDef hLedC; //@info Set with the C API for comparison
+static TIM_TypeDef          hTimInstance;
+static DMA_HandleTypeDef    hDmaCc1;
+static DMA_HandleTypeDef    hDmaCc2;
+static TIM_HandleTypeDef    hTim;
+static uint16_t             BENCH_Log[(WS28XX_PIXEL_MAX * WS28XX_PIXEL_SLOT) + 4096];
+static uint8_t              BENCH_Rgb[WS28XX_PIXEL_MAX * 3];
+static volatile uint32_t    BENCH_Sink;
+
+/************************************************************************************************************
+**************    Private Functions
+************************************************************************************************************/
+
+extern "C" void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PulseFinishedCallback(&hLedA, htim);
+	WS28XX_PulseFinishedCallback(&hLedB, htim);
+	WS28XX_PulseFinishedCallback(&hLedC, htim);
+}
+
+extern "C" void HAL_TIM_PWM_PulseFinishedHalfCpltCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PulseFinishedHalfCpltCallback(&hLedA, htim);
+	WS28XX_PulseFinishedHalfCpltCallback(&hLedB, htim);
+	WS28XX_PulseFinishedHalfCpltCallback(&hLedC, htim);
+}
+
+/***********************************************************************************************************/
+
+static uint64_t BENCH_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/***********************************************************************************************************/
+
+static uint32_t BENCH_Color(uint32_t Index) {
+	uint32_t x = (Index + 1) * 2654435761U;
+	return (x ^ (x >> 15)) & 0xFFFFFF;
+}
+
+/***********************************************************************************************************/
+
+//@info Send the pixels of Handle and decode the logged slots back to bytes
+static uint32_t BENCH_Send(WS28XX_HandleTypeDef *Handle, uint8_t *Byte, uint32_t Size) {
+	uint32_t count = 0;
+	uint8_t  bit   = 0;
+	uint8_t  byte  = 0;
+	HOST_TIM_Reset();
+	HOST_TIM_Capture.Log      = BENCH_Log;
+	HOST_TIM_Capture.Log_Size = sizeof(BENCH_Log) / sizeof(BENCH_Log[0]);
+	WS28XX_Update(Handle);
+	HOST_TIM_Run();
+	for (uint32_t i = 0; (i < HOST_TIM_Capture.Log_Length) && (count < Size); i++) {
+		if (BENCH_Log[i] == 0) {
+			continue;
+		}
+		byte = (uint8_t)((byte << 1) | (BENCH_Log[i] == Handle->Pulse1));
+		if (++bit == 8) {
+			Byte[count++] = byte;
+			bit           = 0;
+		}
+	}
+	return count;
+}
+
+/***********************************************************************************************************/
+
+//@info Decoded frame of Handle must hold red, green and blue of every pixel at Index
+static bool BENCH_Verify(WS28XX_HandleTypeDef *Handle, const uint8_t *Index) {
+	static uint8_t byte[WS28XX_PIXEL_MAX * WS28XX_COLOR_CHANNEL];
+	if (BENCH_Send(Handle, byte, sizeof(byte)) != (uint32_t)Handle->Num_Pixel * WS28XX_COLOR_CHANNEL) {
+		return false;
+	}
+	for (uint16_t i = 0; i < Handle->Num_Pixel; i++) {
+		const uint8_t *px = &byte[i * WS28XX_COLOR_CHANNEL];
+		for (uint8_t c = 0; c < 3; c++) {
+			if (px[Index[c]] != BENCH_Rgb[(i * 3) + c]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/***********************************************************************************************************/
+
+template <typename Func> static double BENCH_Time(Func Run, uint16_t Pixel) {
+	double best = 0;
+	for (uint8_t r = 0; r < 5; r++) {
+		uint64_t start = BENCH_Now();
+		uint64_t elapsed;
+		uint32_t loop = 0;
+		do {
+			Run(Pixel);
+			loop++;
+			elapsed = BENCH_Now() - start;
+		} while (elapsed < BENCH_MIN_NS);
+		double ns = (double)elapsed / loop / Pixel;
+		best      = ((r == 0) || (ns < best)) ? ns : best;
+	}
+	return best;
+}
+
+/***********************************************************************************************************/
+
+int main(void) {
+	static const uint8_t index_rgb[3] = {0, 1, 2};
+	static const uint8_t index_bgr[3] = {2, 1, 0};
+	BENCH_StripA         stripA(hLedA);
+	BENCH_StripB         stripB(hLedB);
+	BENCH_Build          stripC(hLedC);
+	BENCH_Gamma          gamma(hLedC);
+
+	printf("# order=%d gamma=%d channel=%d pixel_max=%d, C++ front end\n", WS28XX_ORDER, WS28XX_GAMMA, WS28XX_COLOR_CHANNEL, WS28XX_PIXEL_MAX);
+	hDmaCc1.Init.Mode             = DMA_NORMAL;
+	hDmaCc1.Init.MemInc           = DMA_MINC_ENABLE;
+	hDmaCc1.Init.MemDataAlignment = (WS28XX_BYTE_PULSE == true) ? DMA_MDATAALIGN_BYTE : DMA_MDATAALIGN_HALFWORD;
+	hDmaCc1.Parent                = &hTim;
+	hDmaCc2                       = hDmaCc1;
+	hTim.Instance                 = &hTimInstance;
+	hTim.hdma[TIM_DMA_ID_CC1]     = &hDmaCc1;
+	hTim.hdma[TIM_DMA_ID_CC2]     = &hDmaCc2;
+	for (uint32_t i = 0; i < WS28XX_PIXEL_MAX; i++) {
+		uint32_t color        = BENCH_Color(i);
+		BENCH_Rgb[(i * 3) + 0] = (uint8_t)(color >> 16);
+		BENCH_Rgb[(i * 3) + 1] = (uint8_t)(color >> 8);
+		BENCH_Rgb[(i * 3) + 2] = (uint8_t)color;
+	}
+
+	// Two orders in one binary, each strip must send its own
+	WS28XX_Init(&hLedA, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, BENCH_PIXEL);
+	HOST_TIM_Run();
+	WS28XX_Init(&hLedB, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_2, BENCH_PIXEL);
+	HOST_TIM_Run();
+	for (uint16_t i = 0; i < BENCH_PIXEL; i++) {
+		stripA.Set(i, BENCH_Rgb[(i * 3) + 0], BENCH_Rgb[(i * 3) + 1], BENCH_Rgb[(i * 3) + 2]);
+	}
+	stripB.Copy(0, BENCH_PIXEL, BENCH_Rgb);
+	if ((BENCH_Verify(&hLedA, index_rgb) == false) || (BENCH_Verify(&hLedB, index_bgr) == false)) {
+		printf("# RGB and BGR strips do not send their own order\n");
+		return EXIT_FAILURE;
+	}
+	printf("# RGB strip on channel 1 and BGR strip on channel 2 send their own order\n");
+
+	// Same order as the build, the template setters must store what the C setters store
+	WS28XX_Init(&hLedC, &hTim, BENCH_TIMER_MHZ, TIM_CHANNEL_1, WS28XX_PIXEL_MAX);
+	HOST_TIM_Run();
+	stripC.Copy(0, WS28XX_PIXEL_MAX, BENCH_Rgb);
+	memcpy(hLedA.Pixel, hLedC.Pixel, sizeof(hLedC.Pixel));
+	for (uint16_t i = 0; i < WS28XX_PIXEL_MAX; i++) {
+		WS28XX_SetPixel_RGB(&hLedC, i, BENCH_Rgb[(i * 3) + 0], BENCH_Rgb[(i * 3) + 1], BENCH_Rgb[(i * 3) + 2]);
+	}
+	if ((WS28XX_GAMMA == false) && (memcmp(hLedA.Pixel, hLedC.Pixel, sizeof(hLedC.Pixel)) != 0)) {
+		printf("# template setters differ from WS28XX_SetPixel_RGB\n");
+		return EXIT_FAILURE;
+	}
+
+	// The compile time gamma table against libm
+	for (uint16_t value = 0; value < 256; value++) {
+		if (BENCH_Gamma::Correct((uint8_t)value) != (uint8_t)((255.0 * pow(value / 255.0, 2.8)) + 0.5)) {
+			printf("# compile time gamma 2.8 differs at %u\n", value);
+			return EXIT_FAILURE;
+		}
+	}
+	gamma.Set(0, 0x204080);
+	if ((hLedC.Pixel[0].Color[1] != BENCH_Gamma::Correct(0x20)) || (hLedC.Pixel[0].Color[0] != BENCH_Gamma::Correct(0x40)) || (hLedC.Pixel[0].Color[2] != BENCH_Gamma::Correct(0x80)) ||
+	    (hLedC.Pixel[0].Brightness != 0x80)) {
+		printf("# GRB gamma 2.8 strip stores the wrong pixel\n");
+		return EXIT_FAILURE;
+	}
+	printf("# template setters match the C setters, gamma 2.8 matches libm\n");
+
+	printf("%-24s %10s\n", "function", "ns/pixel");
+	printf("%-24s %10.2f\n", "WS28XX_SetPixel_RGB", BENCH_Time([](uint16_t Pixel) {
+		       for (uint16_t i = 0; i < Pixel; i++) {
+			       WS28XX_SetPixel_RGB(&hLedC, i, BENCH_Rgb[(i * 3) + 0], BENCH_Rgb[(i * 3) + 1], BENCH_Rgb[(i * 3) + 2]);
+		       }
+		       BENCH_Sink = hLedC.Pixel[0].Color[0];
+	       }, WS28XX_PIXEL_MAX));
+	printf("%-24s %10.2f\n", "Strip::Set", BENCH_Time([&](uint16_t Pixel) {
+		       for (uint16_t i = 0; i < Pixel; i++) {
+			       stripC.Set(i, BENCH_Rgb[(i * 3) + 0], BENCH_Rgb[(i * 3) + 1], BENCH_Rgb[(i * 3) + 2]);
+		       }
+		       BENCH_Sink = hLedC.Pixel[0].Color[0];
+	       }, WS28XX_PIXEL_MAX));
+	printf("%-24s %10.2f\n", "Strip::Set gamma", BENCH_Time([&](uint16_t Pixel) {
+		       for (uint16_t i = 0; i < Pixel; i++) {
+			       gamma.Set(i, BENCH_Rgb[(i * 3) + 0], BENCH_Rgb[(i * 3) + 1], BENCH_Rgb[(i * 3) + 2]);
+		       }
+		       BENCH_Sink = hLedC.Pixel[0].Color[0];
+	       }, WS28XX_PIXEL_MAX));
+	printf("%-24s %10.2f\n", "WS28XX_CopyPixel_RGB_888", BENCH_Time([](uint16_t Pixel) {
+		       WS28XX_CopyPixel_RGB_888(&hLedC, 0, Pixel, BENCH_Rgb);
+		       BENCH_Sink = hLedC.Pixel[0].Color[0];
+	       }, WS28XX_PIXEL_MAX));
+	printf("%-24s %10.2f\n", "Strip::Copy", BENCH_Time([&](uint16_t Pixel) {
+		       stripC.Copy(0, Pixel, BENCH_Rgb);
+		       BENCH_Sink = hLedC.Pixel[0].Color[0];
+	       }, WS28XX_PIXEL_MAX));
+	return EXIT_SUCCESS;
+}
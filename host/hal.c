@@ -0,0 +1,349 @@
+/***********************************************************************************************************
+
+  Host stand-in for the STM32Cube HAL functions used by ws28xx.c.
+
+***********************************************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+#include "spi.h"
+
+/************************************************************************************************************
+**************    Capture
+************************************************************************************************************/
+
+#define HOST_TIM_LOOP_MAX 0x100000 //@info Give up on a circular transfer that is never stopped
+
+HOST_TIM_CaptureTypeDef HOST_TIM_Capture;
+
+void HOST_TIM_Reset(void) {
+	memset(&HOST_TIM_Capture, 0, sizeof(HOST_TIM_Capture));
+}
+
+/***********************************************************************************************************/
+
+static void HOST_TIM_Log(const uint16_t *Data, uint32_t Length) {
+	if (HOST_TIM_Capture.Log == NULL) {
+		return;
+	}
+	if (Length > HOST_TIM_Capture.Log_Size - HOST_TIM_Capture.Log_Length) {
+		Length = HOST_TIM_Capture.Log_Size - HOST_TIM_Capture.Log_Length;
+	}
+	memcpy(&HOST_TIM_Capture.Log[HOST_TIM_Capture.Log_Length], Data, Length * sizeof(uint16_t));
+	HOST_TIM_Capture.Log_Length += Length;
+}
+
+/***********************************************************************************************************/
+
+//@info Log Length items of the captured buffer from item First
+static void HOST_TIM_LogSlots(uint32_t First, uint32_t Length) {
+	if (HOST_TIM_Capture.Byte == false) {
+		HOST_TIM_Log(HOST_TIM_Capture.Buffer + First, Length);
+		return;
+	}
+	for (uint32_t i = 0; i < Length; i++) {
+		uint16_t slot = ((const uint8_t *)HOST_TIM_Capture.Buffer)[First + i];
+		HOST_TIM_Log(&slot, 1);
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Play the three DMA requests of a GPIO frame: update, channel 1 and channel 2 of every period in that order.
+//      The port is logged after channel 1, between Pulse0 and Pulse1, where each lane shows the bit it sends
+static void HOST_TIM_RunGpio(TIM_HandleTypeDef *htim) {
+	static const uint16_t id[3]      = {TIM_DMA_ID_UPDATE, TIM_DMA_ID_CC1, TIM_DMA_ID_CC2};
+	static const uint32_t request[3] = {TIM_DMA_UPDATE, TIM_DMA_CC1, TIM_DMA_CC2};
+	bool                  active     = true;
+	while (HOST_TIM_Capture.Running && active) {
+		bool logged = false;
+		active      = false;
+		for (uint8_t e = 0; e < 3; e++) {
+			DMA_HandleTypeDef *hdma = htim->hdma[id[e]];
+			GPIO_TypeDef      *gpio;
+			uint32_t           value;
+			if ((hdma == NULL) || (hdma->Counter == 0) || ((htim->Instance->DIER & request[e]) == 0)) {
+				continue;
+			}
+			value     = *(const uint32_t *)hdma->Src;
+			gpio      = (GPIO_TypeDef *)(hdma->Dst - offsetof(GPIO_TypeDef, BSRR));
+			gpio->ODR = (gpio->ODR & ~(value >> 16)) | (value & 0xFFFF);
+			if (hdma->Init.MemInc == DMA_MINC_ENABLE) {
+				hdma->Src += sizeof(uint32_t);
+			}
+			hdma->Counter--;
+			active = true;
+			//@info one port state per period, after channel 1 or after channel 2 alone during the latch time
+			if ((e == 1) || ((e == 2) && (logged == false))) {
+				uint16_t port = (uint16_t)gpio->ODR;
+				logged        = true;
+				HOST_TIM_Log(&port, 1);
+			}
+			if ((hdma->Counter == 0) && hdma->IT && (hdma->XferCpltCallback != NULL)) {
+				hdma->XferCpltCallback(hdma);
+			}
+		}
+	}
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Play the running transfer
+ * @note   Sends the captured buffer half by half and raises the half/complete callbacks like the DMA IRQ
+ *         would. In circular mode this repeats until HAL_TIM_PWM_Stop_DMA is called.
+ */
+void HOST_TIM_Run(void) {
+	TIM_HandleTypeDef *htim = HOST_TIM_Capture.HTim;
+	DMA_HandleTypeDef *hdma;
+	uint32_t           half;
+	bool               circular;
+	if (HOST_TIM_Capture.HSpi != NULL) {
+		if (HOST_TIM_Capture.Running == false) {
+			return;
+		}
+		//@info SPI bytes are logged one per slot
+		const uint8_t *data = (const uint8_t *)HOST_TIM_Capture.Buffer;
+		for (uint32_t i = 0; i < HOST_TIM_Capture.Length; i++) {
+			uint16_t byte = data[i];
+			HOST_TIM_Log(&byte, 1);
+		}
+		HOST_TIM_Capture.Running = false;
+		HAL_SPI_TxCpltCallback((SPI_HandleTypeDef *)HOST_TIM_Capture.HSpi);
+		return;
+	}
+	if (htim == NULL) {
+		return;
+	}
+	if (HOST_TIM_Capture.Gpio) {
+		HOST_TIM_RunGpio(htim);
+		return;
+	}
+	hdma     = htim->hdma[TIM_DMA_ID_CC1 + (HOST_TIM_Capture.Channel >> 2)];
+	circular = (hdma != NULL) && (hdma->Init.Mode == DMA_CIRCULAR);
+	for (uint32_t loop = 0; HOST_TIM_Capture.Running && (loop < HOST_TIM_LOOP_MAX); loop++) {
+		half = HOST_TIM_Capture.Length / 2; //@info a callback may have started another transfer
+		if (HOST_TIM_Capture.Burst != 0) {
+			//@info a burst on the update request runs once and completes through the period elapsed callback
+			HOST_TIM_LogSlots(0, HOST_TIM_Capture.Length);
+			HOST_TIM_Capture.Running = false;
+			HAL_TIM_PeriodElapsedCallback(htim);
+			continue;
+		}
+		HOST_TIM_LogSlots(0, half);
+		if (hdma != NULL) {
+			hdma->Counter = HOST_TIM_Capture.Late ? HOST_TIM_Capture.Length : HOST_TIM_Capture.Length - half;
+		}
+		htim->Channel = (HAL_TIM_ActiveChannel)(1U << (HOST_TIM_Capture.Channel >> 2));
+		HAL_TIM_PWM_PulseFinishedHalfCpltCallback(htim);
+		if (HOST_TIM_Capture.Running == false) {
+			break;
+		}
+		HOST_TIM_LogSlots(half, HOST_TIM_Capture.Length - half);
+		if (hdma != NULL) {
+			hdma->Counter = circular ? (HOST_TIM_Capture.Late ? half : HOST_TIM_Capture.Length) : 0;
+		}
+		if (circular == false) {
+			HOST_TIM_Capture.Running = false;
+		}
+		HAL_TIM_PWM_PulseFinishedCallback(htim);
+		htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+	}
+}
+
+/************************************************************************************************************
+**************    HAL Functions
+************************************************************************************************************/
+
+//@info A transfer is still running and HOST_TIM_Capture.Busy asks for the HAL_BUSY of the target
+static bool HOST_TIM_Busy(void) {
+	return HOST_TIM_Capture.Busy && HOST_TIM_Capture.Running;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start_DMA(TIM_HandleTypeDef *htim, uint32_t Channel, const uint32_t *pData, uint16_t Length) {
+	DMA_HandleTypeDef *hdma;
+	if (htim == NULL || pData == NULL) {
+		return HAL_ERROR;
+	}
+	if (HOST_TIM_Busy()) {
+		return HAL_BUSY;
+	}
+	hdma                     = htim->hdma[TIM_DMA_ID_CC1 + (Channel >> 2)];
+	HOST_TIM_Capture.HTim    = htim;
+	HOST_TIM_Capture.Channel = Channel;
+	HOST_TIM_Capture.Burst   = 0;
+	HOST_TIM_Capture.Gpio    = false;
+	HOST_TIM_Capture.Buffer  = (const uint16_t *)pData;
+	HOST_TIM_Capture.Byte    = (hdma != NULL) && (hdma->Init.MemDataAlignment == DMA_MDATAALIGN_BYTE);
+	HOST_TIM_Capture.Length  = Length;
+	HOST_TIM_Capture.Running = true;
+	HOST_TIM_Capture.Count++;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop_DMA(TIM_HandleTypeDef *htim, uint32_t Channel) {
+	(void)htim;
+	(void)Channel;
+	HOST_TIM_Capture.Running = false;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+	if (htim == NULL) {
+		return HAL_ERROR;
+	}
+	htim->Instance->CCR[Channel >> 2] = 0;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_DMABurst_MultiWriteStart(TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress, uint32_t BurstRequestSrc, const uint32_t *BurstBuffer, uint32_t BurstLength, uint32_t DataLength) {
+	if (htim == NULL || BurstBuffer == NULL || BurstBaseAddress != TIM_DMABASE_CCR1 || BurstRequestSrc != TIM_DMA_UPDATE) {
+		return HAL_ERROR;
+	}
+	if (HOST_TIM_Busy()) {
+		return HAL_BUSY;
+	}
+	HOST_TIM_Capture.HTim    = htim;
+	HOST_TIM_Capture.Channel = TIM_CHANNEL_1;
+	HOST_TIM_Capture.Burst   = (BurstLength >> 8) + 1;
+	HOST_TIM_Capture.Gpio    = false;
+	HOST_TIM_Capture.Buffer  = (const uint16_t *)BurstBuffer;
+	HOST_TIM_Capture.Byte    = false;
+	HOST_TIM_Capture.Length  = DataLength;
+	HOST_TIM_Capture.Running = true;
+	HOST_TIM_Capture.Count++;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim, uint32_t BurstRequestSrc) {
+	(void)htim;
+	(void)BurstRequestSrc;
+	HOST_TIM_Capture.Running = false;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim) {
+	if (htim == NULL) {
+		return HAL_ERROR;
+	}
+	if (HOST_TIM_Busy()) {
+		return HAL_BUSY;
+	}
+	HOST_TIM_Capture.HTim    = htim;
+	HOST_TIM_Capture.Gpio    = true;
+	HOST_TIM_Capture.Running = true;
+	HOST_TIM_Capture.Count++;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim) {
+	(void)htim;
+	HOST_TIM_Capture.Running = false;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+static HAL_StatusTypeDef HOST_DMA_Start(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength, bool IT) {
+	if (hdma == NULL || SrcAddress == 0 || DstAddress == 0 || DataLength == 0) {
+		return HAL_ERROR;
+	}
+	hdma->Src     = SrcAddress;
+	hdma->Dst     = DstAddress;
+	hdma->Counter = DataLength;
+	hdma->IT      = IT;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength) {
+	return HOST_DMA_Start(hdma, SrcAddress, DstAddress, DataLength, false);
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength) {
+	return HOST_DMA_Start(hdma, SrcAddress, DstAddress, DataLength, true);
+}
+
+/***********************************************************************************************************/
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size) {
+	if (hspi == NULL || pData == NULL || Size == 0) {
+		return HAL_ERROR;
+	}
+	if (HOST_TIM_Busy()) {
+		return HAL_BUSY;
+	}
+	HOST_TIM_Capture.HSpi    = hspi;
+	HOST_TIM_Capture.Buffer  = (const uint16_t *)(const void *)pData;
+	HOST_TIM_Capture.Length  = Size;
+	HOST_TIM_Capture.Running = true;
+	HOST_TIM_Capture.Count++;
+	return HAL_OK;
+}
+
+/***********************************************************************************************************/
+
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+	(void)hspi;
+}
+
+/***********************************************************************************************************/
+
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+	(void)htim;
+}
+
+/***********************************************************************************************************/
+
+__attribute__((weak)) void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) {
+	(void)htim;
+}
+
+/***********************************************************************************************************/
+
+__attribute__((weak)) void HAL_TIM_PWM_PulseFinishedHalfCpltCallback(TIM_HandleTypeDef *htim) {
+	(void)htim;
+}
+
+/***********************************************************************************************************/
+
+void HAL_Delay(uint32_t Delay) {
+	struct timespec ts = {.tv_sec = Delay / 1000, .tv_nsec = (long)(Delay % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+}
+
+/***********************************************************************************************************/
+
+uint32_t HAL_GetTick(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((ts.tv_sec * 1000ULL) + (ts.tv_nsec / 1000000L));
+}
+
+/***********************************************************************************************************/
+
+uint32_t       SystemCoreClock = 1000000000;
+CoreDebug_Type HOST_CoreDebug;
+
+DWT_Type *HOST_DWT(void) {
+	static DWT_Type dwt;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	dwt.CYCCNT = (uint32_t)((ts.tv_sec * 1000000000ULL) + ts.tv_nsec);
+	return &dwt;
+}
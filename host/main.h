@@ -0,0 +1,57 @@
+#ifndef _HOST_MAIN_H_
+#define _HOST_MAIN_H_
+
+/***********************************************************************************************************
+
+  Host stand-in for the STM32Cube "main.h".
+
+***********************************************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "tim.h"
+
+#ifndef __weak
+#	define __weak __attribute__((weak))
+#endif
+
+static inline uint32_t __get_PRIMASK(void) {
+	return 0;
+}
+static inline void __set_PRIMASK(uint32_t priMask) {
+	(void)priMask;
+}
+static inline void __disable_irq(void) {
+}
+static inline void __enable_irq(void) {
+}
+
+void     HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+
+//@info Cortex-M cycle counter, CYCCNT counts the nanoseconds of CLOCK_MONOTONIC at a SystemCoreClock of 1 GHz
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT                        HOST_DWT()
+#define CoreDebug                  (&HOST_CoreDebug)
+
+extern uint32_t       SystemCoreClock;
+extern CoreDebug_Type HOST_CoreDebug;
+DWT_Type             *HOST_DWT(void); //@info Refreshes CYCCNT on every access
+
+#ifdef __cplusplus
+}
+#endif
+#endif
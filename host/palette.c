@@ -0,0 +1,364 @@
+/***********************************************************************************************************
+
+  Host check and timings of WS28XX_PALETTE.
+
+    palette    check the frames sent through the palette, then time palette animation against pixel writes
+
+  Every check sends a frame through the stand-in DMA, decodes the pulses back to bytes and compares each pixel
+  with its entry worked out from the RGB of the palette here: WS28XX_ORDER, gamma, the brightness, the white
+  extraction and the color LUT. The timings compare rotating or crossfading the palette, whose cost does not
+  depend on the number of pixels, with writing a new index to every pixel.
+
+***********************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ws28xx.h"
+
+/************************************************************************************************************
+**************    Private Definitions
+************************************************************************************************************/
+
+#define PAL_MIN_NS    20000000ULL
+#define PAL_REPEAT    5
+#define PAL_TIMER_MHZ 72
+
+typedef void (*PAL_FuncTypeDef)(void);
+
+/************************************************************************************************************
+**************    Private Variables
+************************************************************************************************************/
+
+extern const uint32_t WS28XX_ReciprocalTable[];
+#if (WS28XX_GAMMA == true)
+extern const uint8_t WS28XX_GammaTable[];
+#endif
+
+static WS28XX_HandleTypeDef hLed;
+static TIM_TypeDef          hTimInstance;
+static TIM_HandleTypeDef    hTim;
+static DMA_HandleTypeDef    hDma = {.Init.Mode             = DMA_NORMAL,
+                                    .Init.MemInc           = DMA_MINC_ENABLE,
+                                    .Init.MemDataAlignment = (WS28XX_BYTE_PULSE == true) ? DMA_MDATAALIGN_BYTE : DMA_MDATAALIGN_HALFWORD,
+                                    .Parent                = &hTim};
+static TIM_HandleTypeDef    hTim = {.Instance = &hTimInstance, .hdma[TIM_DMA_ID_CC1] = &hDma};
+
+static uint16_t PAL_Log[((WS28XX_PIXEL_MAX * WS28XX_PIXEL_SLOT) + 2) + 4096];
+static uint8_t  PAL_Index[WS28XX_PIXEL_MAX];    //@info Entry of every pixel
+static uint8_t  PAL_Rgb[WS28XX_PALETTE][3];     //@info RGB of every entry, red first
+static uint8_t  PAL_Bright[WS28XX_PALETTE];     //@info Brightness of every entry
+static uint8_t  PAL_From[WS28XX_PALETTE][3];    //@info Palettes of the crossfade
+static uint8_t  PAL_To[WS28XX_PALETTE][3];
+static uint8_t  PAL_Amount;
+
+static const uint8_t PAL_OrderIndex[3][3] = {{0, 1, 2}, {2, 1, 0}, {1, 0, 2}};
+
+/************************************************************************************************************
+**************    Private Functions
+************************************************************************************************************/
+
+void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) {
+	WS28XX_PulseFinishedCallback(&hLed, htim);
+}
+
+/***********************************************************************************************************/
+
+static uint64_t PAL_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/***********************************************************************************************************/
+
+//@info Bytes an entry must be sent as, from its RGB and brightness the way WS28XX_SetPixel_RGB stores a color
+static void PAL_Expect(uint16_t Entry, uint8_t *Byte) {
+	const uint8_t *rgb = PAL_Rgb[Entry];
+	uint8_t        color[4] = {0};
+	uint8_t        max      = 0;
+	for (uint8_t c = 0; c < 3; c++) {
+#if (WS28XX_GAMMA == true)
+		color[PAL_OrderIndex[WS28XX_ORDER][c]] = WS28XX_GammaTable[rgb[c]];
+#else
+		color[PAL_OrderIndex[WS28XX_ORDER][c]] = rgb[c];
+#endif
+		max = (color[PAL_OrderIndex[WS28XX_ORDER][c]] > max) ? color[PAL_OrderIndex[WS28XX_ORDER][c]] : max;
+	}
+	if ((PAL_Bright[Entry] != max) && (max != 0)) {
+		uint32_t scale = ((PAL_Bright[Entry] * WS28XX_ReciprocalTable[max]) + 0x80) >> 8;
+		for (uint8_t ch = 0; ch < 3; ch++) {
+			color[ch] = (uint8_t)(((color[ch] * scale) + 0x8000) >> 16);
+		}
+	} else if (PAL_Bright[Entry] == 0) {
+		memset(color, 0, sizeof(color));
+	}
+#if (WS28XX_WHITE_EXTRACT == true)
+	{
+		uint8_t grey = color[0] < color[1] ? color[0] : color[1];
+		grey         = (color[2] < grey) ? color[2] : grey;
+		color[0] -= grey;
+		color[1] -= grey;
+		color[2] -= grey;
+		color[3] = grey;
+	}
+#endif
+	for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+#if (WS28XX_COLOR_LUT == true)
+		Byte[ch] = hLed.Lut[ch][color[ch]];
+#else
+		Byte[ch] = color[ch];
+#endif
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Send a frame, decode it and compare every pixel with the expected bytes of its entry
+static bool PAL_Verify(uint16_t Pixel) {
+	uint8_t  expect[WS28XX_COLOR_CHANNEL];
+	uint32_t bit   = 0;
+	uint32_t count = 0;
+	uint8_t  byte  = 0;
+	HOST_TIM_Reset();
+	HOST_TIM_Capture.Log      = PAL_Log;
+	HOST_TIM_Capture.Log_Size = sizeof(PAL_Log) / sizeof(PAL_Log[0]);
+	WS28XX_Update(&hLed);
+	HOST_TIM_Run();
+	for (uint32_t i = 0; i < HOST_TIM_Capture.Log_Length; i++) {
+		if (PAL_Log[i] == 0) {
+			continue;
+		}
+		byte = (uint8_t)((byte << 1) | (PAL_Log[i] == hLed.Pulse1));
+		if (++bit == 8) {
+			if ((count % WS28XX_COLOR_CHANNEL) == 0) {
+				if (count >= (uint32_t)Pixel * WS28XX_COLOR_CHANNEL) {
+					return false;
+				}
+				PAL_Expect(PAL_Index[count / WS28XX_COLOR_CHANNEL], expect);
+			}
+			if (byte != expect[count % WS28XX_COLOR_CHANNEL]) {
+				return false;
+			}
+			count++;
+			bit = 0;
+		}
+	}
+	return count == (uint32_t)Pixel * WS28XX_COLOR_CHANNEL;
+}
+
+/***********************************************************************************************************/
+
+static void PAL_Init(uint16_t Pixel) {
+	WS28XX_Init(&hLed, &hTim, PAL_TIMER_MHZ, TIM_CHANNEL_1, Pixel);
+	HOST_TIM_Run(); //@info Let the reset frame sent by WS28XX_Init finish
+	memset(PAL_Rgb, 0, sizeof(PAL_Rgb));
+	memset(PAL_Bright, 0, sizeof(PAL_Bright));
+	memset(PAL_Index, 0, sizeof(PAL_Index));
+}
+
+/***********************************************************************************************************/
+
+//@info Keep the RGB of Count entries from First here, with the brightness the setters give it
+static void PAL_Keep(uint16_t First, uint16_t Count, const uint8_t *Rgb) {
+	memcpy(PAL_Rgb[First], Rgb, (size_t)Count * 3);
+	for (uint16_t e = First; e < First + Count; e++) {
+		PAL_Bright[e] = MAX_OF_THREE(PAL_Rgb[e][0], PAL_Rgb[e][1], PAL_Rgb[e][2]);
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Store the RGB of Count entries from First here and in the palette
+static bool PAL_Store(uint16_t First, uint16_t Count, const uint8_t *Rgb) {
+	PAL_Keep(First, Count, Rgb);
+	return WS28XX_CopyPalette_RGB_888(&hLed, (uint8_t)First, Count, Rgb);
+}
+
+/***********************************************************************************************************/
+
+//@info Crossfade the whole palette and keep the rounded mix here
+static bool PAL_Blend(const uint8_t *From, const uint8_t *To, uint8_t Amount) {
+	uint8_t mix[WS28XX_PALETTE][3];
+	for (uint16_t e = 0; e < WS28XX_PALETTE; e++) {
+		for (uint8_t c = 0; c < 3; c++) {
+			mix[e][c] = (uint8_t)(((From[(e * 3) + c] * (255U - Amount)) + (To[(e * 3) + c] * Amount) + 127U) / 255U);
+		}
+	}
+	PAL_Keep(0, WS28XX_PALETTE, mix[0]);
+	return WS28XX_BlendPalette(&hLed, 0, WS28XX_PALETTE, From, To, Amount);
+}
+
+/***********************************************************************************************************/
+
+//@info Rotate the entries kept here the way WS28XX_RotatePalette rotates the palette
+static void PAL_Rotate(uint16_t First, uint16_t Count, uint16_t Shift) {
+	uint8_t rgb[WS28XX_PALETTE][3];
+	uint8_t bright[WS28XX_PALETTE];
+	memcpy(rgb, PAL_Rgb, sizeof(rgb));
+	memcpy(bright, PAL_Bright, sizeof(bright));
+	for (uint16_t i = 0; i < Count; i++) {
+		uint16_t to = First + ((i + Shift) % Count);
+		memcpy(PAL_Rgb[to], rgb[First + i], 3);
+		PAL_Bright[to] = bright[First + i];
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info A gradient palette, an index pattern over the pixels, rotations, a crossfade, the global brightness, the
+//      LUT and the refused calls
+static bool PAL_Check(uint16_t Pixel) {
+	bool    same = true;
+	uint8_t rgb[WS28XX_PALETTE][3];
+	PAL_Init(Pixel);
+	same &= PAL_Verify(Pixel);
+	for (uint16_t e = 0; e < WS28XX_PALETTE; e++) {
+		uint8_t step = (uint8_t)((e * 255U) / WS28XX_PALETTE);
+		rgb[e][0]    = step;
+		rgb[e][1]    = (uint8_t)(255 - step);
+		rgb[e][2]    = (uint8_t)((e * 37U) & 0xFF);
+	}
+	same &= PAL_Store(0, WS28XX_PALETTE, rgb[0]);
+	for (uint16_t i = 0; i < Pixel; i++) {
+		PAL_Index[i] = (uint8_t)(((i * 7U) + (i >> 4)) % WS28XX_PALETTE);
+	}
+	same &= WS28XX_CopyPixel_Index(&hLed, 0, Pixel, PAL_Index);
+	same &= PAL_Verify(Pixel);
+	//@info one pixel and a filled range
+	PAL_Index[3] = WS28XX_PALETTE - 1;
+	memset(&PAL_Index[Pixel / 2U], 1, Pixel / 4U);
+	same &= WS28XX_SetPixel_Index(&hLed, 3, WS28XX_PALETTE - 1);
+	same &= WS28XX_FillPixel_Index(&hLed, Pixel / 2U, Pixel / 4U, 1);
+	same &= PAL_Verify(Pixel);
+	//@info up by 5 over the whole palette, one down inside a part of it
+	same &= WS28XX_RotatePalette(&hLed, 0, WS28XX_PALETTE, 5);
+	PAL_Rotate(0, WS28XX_PALETTE, 5);
+	same &= PAL_Verify(Pixel);
+	same &= WS28XX_RotatePalette(&hLed, 2, WS28XX_PALETTE / 2U, (WS28XX_PALETTE / 2U) - 1);
+	PAL_Rotate(2, WS28XX_PALETTE / 2U, (WS28XX_PALETTE / 2U) - 1);
+	same &= PAL_Verify(Pixel);
+	same &= WS28XX_RotatePalette(&hLed, 0, WS28XX_PALETTE, WS28XX_PALETTE);
+	same &= PAL_Verify(Pixel);
+	//@info the ends of a crossfade are its two palettes, the middle the rounded mix
+	for (uint16_t e = 0; e < WS28XX_PALETTE; e++) {
+		for (uint8_t c = 0; c < 3; c++) {
+			rgb[e][c] = (uint8_t)(255 - rgb[e][c]);
+		}
+	}
+	memcpy(PAL_From, PAL_Rgb, sizeof(PAL_From));
+	for (uint8_t amount = 0; amount < 3; amount++) {
+		same &= PAL_Blend(PAL_From[0], rgb[0], (uint8_t)((amount * 255U) / 2U));
+		same &= PAL_Verify(Pixel);
+	}
+	//@info the global brightness is set on every entry, until the entry is written again
+	WS28XX_SetAllPixel_Brightness(&hLed, 40);
+	memset(PAL_Bright, 40, sizeof(PAL_Bright));
+	same &= PAL_Verify(Pixel);
+	same &= WS28XX_SetPalette_RGB(&hLed, 1, 200, 10, 90);
+	PAL_Keep(1, 1, (const uint8_t[]){200, 10, 90});
+	same &= PAL_Verify(Pixel);
+#if (WS28XX_COLOR_LUT == true)
+	//@info a LUT change corrects the palette again on the next update
+	WS28XX_SetGamma(&hLed, 2.2f);
+	WS28XX_SetColorCorrection(&hLed, 255, 200, 150);
+	same &= PAL_Verify(Pixel);
+#endif
+	//@info refused, nothing changes
+	same &= (WS28XX_SetPixel_Index(&hLed, Pixel, 0) == false);
+	same &= (WS28XX_FillPixel_Index(&hLed, Pixel - 1, 2, 0) == false);
+	same &= (WS28XX_CopyPalette_RGB_888(&hLed, 1, WS28XX_PALETTE, rgb[0]) == false);
+	same &= (WS28XX_RotatePalette(&hLed, 1, WS28XX_PALETTE, 1) == false);
+	same &= (WS28XX_BlendPalette(&hLed, 0, WS28XX_PALETTE, NULL, rgb[0], 1) == false);
+#if (WS28XX_PALETTE < 256)
+	same &= (WS28XX_SetPixel_Index(&hLed, 0, WS28XX_PALETTE) == false);
+	same &= (WS28XX_SetPalette_RGB(&hLed, WS28XX_PALETTE, 1, 2, 3) == false);
+	PAL_Index[0] = WS28XX_PALETTE;
+	same &= (WS28XX_CopyPixel_Index(&hLed, 0, Pixel, PAL_Index) == false);
+	PAL_Index[0] = 0;
+#endif
+	same &= PAL_Verify(Pixel);
+	return same;
+}
+
+/***********************************************************************************************************/
+
+//@info One frame of palette animation, or of writing every pixel
+static void PAL_Rotate_Palette(void) {
+	WS28XX_RotatePalette(&hLed, 0, WS28XX_PALETTE, 1);
+}
+
+static void PAL_Blend_Palette(void) {
+	WS28XX_BlendPalette(&hLed, 0, WS28XX_PALETTE, PAL_From[0], PAL_To[0], PAL_Amount++);
+}
+
+static void PAL_Copy_Pixel(void) {
+	for (uint16_t i = 0; i < hLed.Num_Pixel; i++) {
+		PAL_Index[i] = (uint8_t)((PAL_Index[i] + 1U) % WS28XX_PALETTE);
+	}
+	WS28XX_CopyPixel_Index(&hLed, 0, hLed.Num_Pixel, PAL_Index);
+}
+
+static void PAL_Set_Pixel(void) {
+	for (uint16_t i = 0; i < hLed.Num_Pixel; i++) {
+		WS28XX_SetPixel_Index(&hLed, i, (uint8_t)((hLed.Pixel[i] + 1U) % WS28XX_PALETTE));
+	}
+}
+
+static void PAL_Rotate_Update(void) {
+	WS28XX_RotatePalette(&hLed, 0, WS28XX_PALETTE, 1);
+	WS28XX_Update(&hLed);
+}
+
+/***********************************************************************************************************/
+
+//@info Best time of one call in ns
+static double PAL_Run(PAL_FuncTypeDef Func) {
+	double best = 0;
+	for (int r = 0; r < PAL_REPEAT; r++) {
+		uint64_t loops = 0;
+		uint64_t start = PAL_Now();
+		uint64_t elapsed;
+		do {
+			Func();
+			loops++;
+			elapsed = PAL_Now() - start;
+		} while (elapsed < PAL_MIN_NS / PAL_REPEAT);
+		double ns = (double)elapsed / (double)loops;
+		if ((r == 0) || (ns < best)) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+/************************************************************************************************************
+**************    Public Functions
+************************************************************************************************************/
+
+int main(void) {
+	const uint16_t pixel = WS28XX_PIXEL_MAX;
+	if ((PAL_Check(pixel) == false) || (PAL_Check(WS28XX_PALETTE / 3U) == false)) {
+		printf("# palette frame does not match the entries\n");
+		return EXIT_FAILURE;
+	}
+	printf("# palette: %u entries, %u pixels, pixels %zu bytes + palette %zu bytes against %zu bytes of RGB pixels, decoded frames match\n", WS28XX_PALETTE, pixel,
+	       sizeof(hLed.Pixel), sizeof(hLed.Palette) + sizeof(hLed.Palette_Byte), (size_t)pixel * sizeof(WS28XX_PixelTypeDef));
+
+	PAL_Init(pixel);
+	for (uint16_t e = 0; e < WS28XX_PALETTE; e++) {
+		PAL_From[e][0] = (uint8_t)e;
+		PAL_To[e][2]   = (uint8_t)e;
+		PAL_Index[e]   = (uint8_t)e;
+	}
+	WS28XX_CopyPalette_RGB_888(&hLed, 0, WS28XX_PALETTE, PAL_From[0]);
+	for (uint16_t i = 0; i < pixel; i++) {
+		PAL_Index[i] = (uint8_t)(i % WS28XX_PALETTE);
+	}
+	WS28XX_CopyPixel_Index(&hLed, 0, pixel, PAL_Index);
+	printf("# palette animation step [us/frame]: RotatePalette %.2f, BlendPalette %.2f, CopyPixel_Index %.2f, SetPixel_Index %.2f\n", PAL_Run(PAL_Rotate_Palette) / 1000.0,
+	       PAL_Run(PAL_Blend_Palette) / 1000.0, PAL_Run(PAL_Copy_Pixel) / 1000.0, PAL_Run(PAL_Set_Pixel) / 1000.0);
+	printf("# palette RotatePalette + WS28XX_Update [ns/pixel]: %.2f\n", PAL_Run(PAL_Rotate_Update) / pixel);
+	return EXIT_SUCCESS;
+}
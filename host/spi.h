@@ -0,0 +1,37 @@
+#ifndef _HOST_SPI_H_
+#define _HOST_SPI_H_
+
+/***********************************************************************************************************
+
+  Host stand-in for the STM32Cube "spi.h" / HAL SPI API.
+
+  Only the subset used by ws28xx.c is provided. HAL_SPI_Transmit_DMA records the buffer in HOST_TIM_Capture,
+  HOST_TIM_Run() sends it and raises HAL_SPI_TxCpltCallback.
+
+***********************************************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/************************************************************************************************************
+**************    HAL Definitions
+************************************************************************************************************/
+
+typedef struct {
+	void *Instance;
+} SPI_HandleTypeDef;
+
+/************************************************************************************************************
+**************    HAL Functions
+************************************************************************************************************/
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size);
+void              HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
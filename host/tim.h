@@ -0,0 +1,181 @@
+#ifndef _HOST_TIM_H_
+#define _HOST_TIM_H_
+
+/***********************************************************************************************************
+
+  Host stand-in for the STM32Cube "tim.h" / HAL TIM+DMA API.
+
+  Only the subset used by ws28xx.c is provided. Instead of driving a timer, HAL_TIM_PWM_Start_DMA records
+  the buffer and length it was handed so the benchmark can inspect exactly what would be sent to the LEDs.
+
+***********************************************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/************************************************************************************************************
+**************    HAL Definitions
+************************************************************************************************************/
+
+typedef enum {
+	HAL_OK      = 0x00U,
+	HAL_ERROR   = 0x01U,
+	HAL_BUSY    = 0x02U,
+	HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define TIM_CHANNEL_1 0x00000000U
+#define TIM_CHANNEL_2 0x00000004U
+#define TIM_CHANNEL_3 0x00000008U
+#define TIM_CHANNEL_4 0x0000000CU
+#define TIM_CHANNEL_5 0x00000010U
+#define TIM_CHANNEL_6 0x00000014U
+
+#define TIM_DMA_ID_UPDATE      ((uint16_t)0x0000)
+#define TIM_DMA_ID_CC1         ((uint16_t)0x0001)
+#define TIM_DMA_ID_CC2         ((uint16_t)0x0002)
+#define TIM_DMA_ID_CC3         ((uint16_t)0x0003)
+#define TIM_DMA_ID_CC4         ((uint16_t)0x0004)
+#define TIM_DMA_ID_COMMUTATION ((uint16_t)0x0005)
+#define TIM_DMA_ID_TRIGGER     ((uint16_t)0x0006)
+
+typedef enum {
+	HAL_TIM_ACTIVE_CHANNEL_1       = 0x01U,
+	HAL_TIM_ACTIVE_CHANNEL_2       = 0x02U,
+	HAL_TIM_ACTIVE_CHANNEL_3       = 0x04U,
+	HAL_TIM_ACTIVE_CHANNEL_4       = 0x08U,
+	HAL_TIM_ACTIVE_CHANNEL_5       = 0x10U,
+	HAL_TIM_ACTIVE_CHANNEL_6       = 0x20U,
+	HAL_TIM_ACTIVE_CHANNEL_CLEARED = 0x00U
+} HAL_TIM_ActiveChannel;
+
+#define TIM_DMABASE_CCR1 0x0000000DU
+#define TIM_DMA_UPDATE   0x00000100U
+#define TIM_DMA_CC1      0x00000200U
+#define TIM_DMA_CC2      0x00000400U
+
+#define TIM_DMABURSTLENGTH_1TRANSFER  0x00000000U
+#define TIM_DMABURSTLENGTH_2TRANSFERS 0x00000100U
+#define TIM_DMABURSTLENGTH_3TRANSFERS 0x00000200U
+#define TIM_DMABURSTLENGTH_4TRANSFERS 0x00000300U
+
+#define DMA_NORMAL   0x00000000U
+#define DMA_CIRCULAR 0x00000100U
+
+#define DMA_MINC_DISABLE 0x00000000U
+#define DMA_MINC_ENABLE  0x00000400U
+
+#define DMA_MDATAALIGN_BYTE     0x00000000U
+#define DMA_MDATAALIGN_HALFWORD 0x00002000U
+#define DMA_MDATAALIGN_WORD     0x00004000U
+
+typedef struct {
+	uint32_t Mode;
+	uint32_t MemInc;
+	uint32_t MemDataAlignment;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+	DMA_InitTypeDef   Init;
+	void             *Parent;
+	void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+	volatile uint32_t Counter; //@info Remaining items, what NDTR/CNDTR holds on target
+	uintptr_t         Src;     //@info Transfer of HAL_DMA_Start, played by HOST_TIM_Run()
+	uintptr_t         Dst;
+	bool              IT;
+} DMA_HandleTypeDef;
+
+typedef struct {
+	volatile uint32_t ODR;
+	volatile uint32_t BSRR; //@info Written by the stand-in DMA only, HOST_TIM_Run() applies it to ODR
+} GPIO_TypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Counter)
+
+typedef struct {
+	volatile uint32_t DIER;
+	volatile uint32_t CNT;
+	volatile uint32_t PSC;
+	volatile uint32_t ARR;
+	volatile uint32_t CCR[6];
+} TIM_TypeDef;
+
+typedef struct {
+	uint32_t Prescaler;
+	uint32_t Period;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+	TIM_TypeDef          *Instance;
+	TIM_Base_InitTypeDef  Init;
+	HAL_TIM_ActiveChannel Channel;
+	DMA_HandleTypeDef    *hdma[7];
+} TIM_HandleTypeDef;
+
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) \
+	do {                                                     \
+		(__HANDLE__)->Instance->ARR = (__AUTORELOAD__);      \
+		(__HANDLE__)->Init.Period   = (__AUTORELOAD__);      \
+	} while (0)
+
+#define __HAL_TIM_SET_PRESCALER(__HANDLE__, __PRESC__) ((__HANDLE__)->Instance->PSC = (__PRESC__))
+
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__)                       ((__HANDLE__)->Instance->ARR)
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__)             ((__HANDLE__)->Instance->CNT = (__COUNTER__))
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) ((__HANDLE__)->Instance->CCR[(__CHANNEL__) >> 2] = (__COMPARE__))
+#define __HAL_TIM_ENABLE_DMA(__HANDLE__, __DMA__)                  ((__HANDLE__)->Instance->DIER |= (__DMA__))
+#define __HAL_TIM_DISABLE_DMA(__HANDLE__, __DMA__)                 ((__HANDLE__)->Instance->DIER &= ~(__DMA__))
+
+/************************************************************************************************************
+**************    Capture
+************************************************************************************************************/
+
+typedef struct {
+	TIM_HandleTypeDef *HTim;
+	uint32_t           Channel;
+	void              *HSpi;       //@info SPI handle of HAL_SPI_Transmit_DMA, the Buffer bytes are sent on MOSI
+	uint32_t           Burst;      //@info Compare registers written per update event by a DMA burst, 0 for a channel DMA
+	const uint16_t    *Buffer;
+	bool               Byte;       //@info Channel DMA reads bytes (DMA_MDATAALIGN_BYTE), each is widened to a compare value
+	uint32_t           Length;
+	uint32_t           Count;
+	bool               Running;
+	bool               Gpio;       //@info Timer started by HAL_TIM_Base_Start, HOST_TIM_Run() plays the DMA requests on the port
+	bool               Late;       //@info Report the DMA counter as if every callback ran too late
+	bool               Busy;       //@info Refuse a start with HAL_BUSY while a transfer is running, as the HAL does on target
+	uint16_t          *Log;        //@info Optional, every slot sent by HOST_TIM_Run() is appended here
+	uint32_t           Log_Size;
+	uint32_t           Log_Length;
+} HOST_TIM_CaptureTypeDef;
+
+extern HOST_TIM_CaptureTypeDef HOST_TIM_Capture;
+
+void HOST_TIM_Reset(void);
+void HOST_TIM_Run(void);
+
+/************************************************************************************************************
+**************    HAL Functions
+************************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start_DMA(TIM_HandleTypeDef *htim, uint32_t Channel, const uint32_t *pData, uint16_t Length);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop_DMA(TIM_HandleTypeDef *htim, uint32_t Channel);
+void              HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim);
+void              HAL_TIM_PWM_PulseFinishedHalfCpltCallback(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_DMABurst_MultiWriteStart(TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress, uint32_t BurstRequestSrc, const uint32_t *BurstBuffer, uint32_t BurstLength, uint32_t DataLength);
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim, uint32_t BurstRequestSrc);
+void              HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -37,28 +37,149 @@ extern "C" {
     MiddleWare fileName : NimaLTD.I-CUBE-WS28XX_conf.h
 */
 /*---------- WS28XX_PIXEL_MAX  -----------*/
-#	define WS28XX_PIXEL_MAX 256
+#	ifndef WS28XX_PIXEL_MAX
+#		define WS28XX_PIXEL_MAX 256
+#	endif
 
 /*---------- WS28XX_PIXEL_MAX_BRIGHTNESS  -----------*/
-#	define WS28XX_PIXEL_MAX_BRIGHTNESS 255
+#	ifndef WS28XX_PIXEL_MAX_BRIGHTNESS
+#		define WS28XX_PIXEL_MAX_BRIGHTNESS 255
+#	endif
+
+/*---------- WS28XX_EXTERNAL_BUFFER  -----------*/
+#	ifndef WS28XX_EXTERNAL_BUFFER
+#		define WS28XX_EXTERNAL_BUFFER 0
+#	endif
+
+/*---------- WS28XX_FRAMEBUFFER  -----------*/
+#	ifndef WS28XX_FRAMEBUFFER
+#		define WS28XX_FRAMEBUFFER 0
+#	endif
 
 /*---------- WS28XX_PULSE_LENGTH_NS  -----------*/
-#	define WS28XX_PULSE_LENGTH_NS 1250
+#	ifndef WS28XX_PULSE_LENGTH_NS
+#		define WS28XX_PULSE_LENGTH_NS 1250
+#	endif
 
 /*---------- WS28XX_PULSE_0_NS  -----------*/
-#	define WS28XX_PULSE_0_NS 400
+#	ifndef WS28XX_PULSE_0_NS
+#		define WS28XX_PULSE_0_NS 400
+#	endif
 
 /*---------- WS28XX_PULSE_1_NS  -----------*/
-#	define WS28XX_PULSE_1_NS 800
+#	ifndef WS28XX_PULSE_1_NS
+#		define WS28XX_PULSE_1_NS 800
+#	endif
+
+/*---------- WS28XX_BYTE_PULSE  -----------*/
+#	ifndef WS28XX_BYTE_PULSE
+#		define WS28XX_BYTE_PULSE 0
+#	endif
 
 /*---------- WS28XX_ORDER  -----------*/
-#	define WS28XX_ORDER WS28XX_ORDER_GRB
+#	ifndef WS28XX_ORDER
+#		define WS28XX_ORDER WS28XX_ORDER_GRB
+#	endif
 
 /*---------- WS28XX_GAMMA  -----------*/
-#	define WS28XX_GAMMA 0
+#	ifndef WS28XX_GAMMA
+#		define WS28XX_GAMMA 0
+#	endif
+
+/*---------- WS28XX_COLOR_CHANNEL  -----------*/
+#	ifndef WS28XX_COLOR_CHANNEL
+#		define WS28XX_COLOR_CHANNEL 3
+#	endif
+
+/*---------- WS28XX_WHITE_EXTRACT  -----------*/
+#	ifndef WS28XX_WHITE_EXTRACT
+#		define WS28XX_WHITE_EXTRACT 0
+#	endif
+
+/*---------- WS28XX_ENCODER_TABLE  -----------*/
+#	ifndef WS28XX_ENCODER_TABLE
+#		define WS28XX_ENCODER_TABLE 0
+#	endif
+
+/*---------- WS28XX_COLOR_LUT  -----------*/
+#	ifndef WS28XX_COLOR_LUT
+#		define WS28XX_COLOR_LUT 0
+#	endif
+
+/*---------- WS28XX_SKIP_CLEAN_UPDATE  -----------*/
+#	ifndef WS28XX_SKIP_CLEAN_UPDATE
+#		define WS28XX_SKIP_CLEAN_UPDATE 0
+#	endif
+
+/*---------- WS28XX_DOUBLE_BUFFER  -----------*/
+#	ifndef WS28XX_DOUBLE_BUFFER
+#		define WS28XX_DOUBLE_BUFFER 0
+#	endif
+
+/*---------- WS28XX_MULTI_CHANNEL  -----------*/
+#	ifndef WS28XX_MULTI_CHANNEL
+#		define WS28XX_MULTI_CHANNEL 1
+#	endif
+
+/*---------- WS28XX_GPIO_LANE  -----------*/
+#	ifndef WS28XX_GPIO_LANE
+#		define WS28XX_GPIO_LANE 0
+#	endif
+
+/*---------- WS28XX_SPI_SYMBOL  -----------*/
+#	ifndef WS28XX_SPI_SYMBOL
+#		define WS28XX_SPI_SYMBOL 0
+#	endif
+
+/*---------- WS28XX_STREAM  -----------*/
+#	ifndef WS28XX_STREAM
+#		define WS28XX_STREAM 0
+#	endif
+
+/*---------- WS28XX_STREAM_PIXEL  -----------*/
+#	ifndef WS28XX_STREAM_PIXEL
+#		define WS28XX_STREAM_PIXEL 8
+#	endif
+
+/*---------- WS28XX_SCHEDULER  -----------*/
+#	ifndef WS28XX_SCHEDULER
+#		define WS28XX_SCHEDULER 0
+#	endif
+
+/*---------- WS28XX_QUEUE  -----------*/
+#	ifndef WS28XX_QUEUE
+#		define WS28XX_QUEUE 0
+#	endif
+
+/*---------- WS28XX_MATRIX  -----------*/
+#	ifndef WS28XX_MATRIX
+#		define WS28XX_MATRIX 0
+#	endif
+
+/*---------- WS28XX_INGEST  -----------*/
+#	ifndef WS28XX_INGEST
+#		define WS28XX_INGEST 0
+#	endif
+
+/*---------- WS28XX_ANIMATION  -----------*/
+#	ifndef WS28XX_ANIMATION
+#		define WS28XX_ANIMATION 0
+#	endif
+
+/*---------- WS28XX_PALETTE  -----------*/
+#	ifndef WS28XX_PALETTE
+#		define WS28XX_PALETTE 0
+#	endif
+
+/*---------- WS28XX_STATS  -----------*/
+#	ifndef WS28XX_STATS
+#		define WS28XX_STATS 0
+#	endif
 
 /*---------- WS28XX_RTOS  -----------*/
-#	define WS28XX_RTOS WS28XX_RTOS_DISABLE
+#	ifndef WS28XX_RTOS
+#		define WS28XX_RTOS WS28XX_RTOS_DISABLE
+#	endif
 
 #	ifdef __cplusplus
 }
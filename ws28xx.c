@@ -5,8 +5,14 @@
 
 #include "ws28xx.h"
 #include <string.h>
+#if (WS28XX_COLOR_LUT == true)
+#	include <math.h>
+#endif
 #include "stdio.h"
 #include "main.h"
+#if (WS28XX_QUEUE > 0)
+#	include <stdatomic.h>
+#endif
 
 #if WS28XX_RTOS == WS28XX_RTOS_DISABLE
 #elif WS28XX_RTOS == WS28XX_RTOS_CMSIS_V1
@@ -23,7 +29,169 @@
 **************    Private Definitions
 ************************************************************************************************************/
 
-// none
+#if (WS28XX_COLOR_LUT == true) && (WS28XX_GAMMA == true)
+#	error "WS28XX_COLOR_LUT applies gamma itself, disable WS28XX_GAMMA and use WS28XX_SetGamma()"
+#endif
+
+#if (WS28XX_STREAM == true) && (WS28XX_DOUBLE_BUFFER == true)
+#	error "WS28XX_STREAM already overlaps encoding and sending, disable WS28XX_DOUBLE_BUFFER"
+#endif
+
+#if (WS28XX_MULTI_CHANNEL < 1) || (WS28XX_MULTI_CHANNEL > 4)
+#	error "WS28XX_MULTI_CHANNEL must be 1 to 4, the DMA burst writes CCR1 to CCR4 and CCR5/CCR6 are not next to them"
+#endif
+
+#if (WS28XX_MULTI_CHANNEL > 1) && ((WS28XX_STREAM == true) || (WS28XX_DOUBLE_BUFFER == true))
+#	error "WS28XX_MULTI_CHANNEL cannot be combined with WS28XX_STREAM or WS28XX_DOUBLE_BUFFER"
+#endif
+
+#if (WS28XX_GPIO_LANE != 0) && (WS28XX_GPIO_LANE != 8) && (WS28XX_GPIO_LANE != 16)
+#	error "WS28XX_GPIO_LANE must be 0, 8 or 16"
+#endif
+
+#if (WS28XX_GPIO_LANE > 0) && ((WS28XX_STREAM == true) || (WS28XX_DOUBLE_BUFFER == true) || (WS28XX_MULTI_CHANNEL > 1))
+#	error "WS28XX_GPIO_LANE cannot be combined with WS28XX_STREAM, WS28XX_DOUBLE_BUFFER or WS28XX_MULTI_CHANNEL"
+#endif
+
+#if (WS28XX_SPI_SYMBOL != 0) && (WS28XX_SPI_SYMBOL != 3) && (WS28XX_SPI_SYMBOL != 4)
+#	error "WS28XX_SPI_SYMBOL must be 0, 3 or 4"
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0) && ((WS28XX_STREAM == true) || (WS28XX_DOUBLE_BUFFER == true) || (WS28XX_MULTI_CHANNEL > 1) || (WS28XX_GPIO_LANE > 0))
+#	error "WS28XX_SPI_SYMBOL cannot be combined with WS28XX_STREAM, WS28XX_DOUBLE_BUFFER, WS28XX_MULTI_CHANNEL or WS28XX_GPIO_LANE"
+#endif
+
+#if (WS28XX_QUEUE > 0) && ((WS28XX_QUEUE & (WS28XX_QUEUE - 1)) != 0)
+#	error "WS28XX_QUEUE must be a power of 2"
+#endif
+
+#if (WS28XX_QUEUE > 0) && (WS28XX_FRAMEBUFFER == true)
+#	error "WS28XX_QUEUE applies commands to the pixels of the handle, WS28XX_FRAMEBUFFER has none"
+#endif
+
+#if (WS28XX_MATRIX == true) && (WS28XX_FRAMEBUFFER == true)
+#	error "WS28XX_MATRIX draws into the pixels of the handle, WS28XX_FRAMEBUFFER has none"
+#endif
+
+#if (WS28XX_INGEST == true) && (WS28XX_FRAMEBUFFER == true)
+#	error "WS28XX_INGEST writes into the pixels of the handle, WS28XX_FRAMEBUFFER has none"
+#endif
+
+#if (WS28XX_ANIMATION == true) && (WS28XX_FRAMEBUFFER == true)
+#	error "WS28XX_ANIMATION decodes into the pixels of the handle, WS28XX_FRAMEBUFFER has none"
+#endif
+
+#if (WS28XX_PALETTE > 256)
+#	error "WS28XX_PALETTE is the number of palette entries, a pixel holds a uint8_t index"
+#endif
+
+#if (WS28XX_PALETTE > 0) && (WS28XX_FRAMEBUFFER == true)
+#	error "WS28XX_PALETTE stores an index per pixel in the handle, WS28XX_FRAMEBUFFER has no pixels"
+#endif
+
+#if (WS28XX_PALETTE > 0) && ((WS28XX_QUEUE > 0) || (WS28XX_MATRIX == true) || (WS28XX_INGEST == true) || (WS28XX_ANIMATION == true))
+#	error "WS28XX_QUEUE, WS28XX_MATRIX, WS28XX_INGEST and WS28XX_ANIMATION store RGB pixels, WS28XX_PALETTE pixels are indexes"
+#endif
+
+#if (WS28XX_QUEUE > 0) && defined(__CORTEX_M) && (__CORTEX_M < 3)
+#	error "WS28XX_QUEUE needs the LDREX/STREX atomics of Cortex-M3 and up"
+#endif
+
+#if (WS28XX_STATS == true) && defined(__CORTEX_M) && (__CORTEX_M < 3)
+#	error "WS28XX_STATS needs the DWT cycle counter of Cortex-M3 and up"
+#endif
+
+#if (WS28XX_COLOR_CHANNEL != 3) && (WS28XX_COLOR_CHANNEL != 4)
+#	error "WS28XX_COLOR_CHANNEL must be 3 (RGB) or 4 (RGBW)"
+#endif
+
+#if (WS28XX_WHITE_EXTRACT == true) && (WS28XX_COLOR_CHANNEL != 4)
+#	error "WS28XX_WHITE_EXTRACT needs the white LED of WS28XX_COLOR_CHANNEL 4"
+#endif
+
+#if (WS28XX_BYTE_PULSE == true) && ((WS28XX_MULTI_CHANNEL > 1) || (WS28XX_GPIO_LANE > 0) || (WS28XX_SPI_SYMBOL > 0))
+#	error "WS28XX_BYTE_PULSE is for the PWM backend, disable it with WS28XX_MULTI_CHANNEL, WS28XX_GPIO_LANE or WS28XX_SPI_SYMBOL"
+#endif
+
+#if (WS28XX_STREAM == false) && (WS28XX_SPI_SYMBOL == 0) && (WS28XX_EXTERNAL_BUFFER == false) && (WS28XX_BUFFER_SLOT(WS28XX_PIXEL_MAX) > 65535)
+#	error "WS28XX_PIXEL_MAX pulses do not fit one DMA transfer of 65535 slots, lower it or enable WS28XX_STREAM"
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0) && (WS28XX_EXTERNAL_BUFFER == false) && (WS28XX_BUFFER_SLOT(WS28XX_PIXEL_MAX) > 65535)
+#	error "WS28XX_PIXEL_MAX SPI bytes do not fit one DMA transfer of 65535 bytes, lower it or WS28XX_SPI_SYMBOL"
+#endif
+
+#define WS28XX_DMA_ID(Channel)      (TIM_DMA_ID_CC1 + ((Channel) >> 2))
+#define WS28XX_ACTIVE_CH(Channel)   ((HAL_TIM_ActiveChannel)(1U << ((Channel) >> 2)))
+
+#if (WS28XX_EXTERNAL_BUFFER == true)
+#	define WS28XX_CAPACITY(Handle)   ((Handle)->Buffer_Pixel)
+#else
+#	define WS28XX_CAPACITY(Handle)   WS28XX_PIXEL_MAX
+#endif
+
+#define WS28XX_BACKEND_PWM          ((WS28XX_GPIO_LANE == 0) && (WS28XX_SPI_SYMBOL == 0))
+
+#if (WS28XX_SPI_SYMBOL > 0)
+//@info High bits of the 0 and 1 symbols, WS28XX_PULSE_0_NS and WS28XX_PULSE_1_NS rounded to the SPI bit time
+#	define WS28XX_SPI_HIGH_0 (((WS28XX_PULSE_0_NS * WS28XX_SPI_SYMBOL) + (WS28XX_PULSE_LENGTH_NS / 2)) / WS28XX_PULSE_LENGTH_NS)
+#	define WS28XX_SPI_HIGH_1 (((WS28XX_PULSE_1_NS * WS28XX_SPI_SYMBOL) + (WS28XX_PULSE_LENGTH_NS / 2)) / WS28XX_PULSE_LENGTH_NS)
+#	if (WS28XX_SPI_HIGH_0 < 1) || (WS28XX_SPI_HIGH_1 <= WS28XX_SPI_HIGH_0) || (WS28XX_SPI_HIGH_1 >= WS28XX_SPI_SYMBOL)
+#		error "WS28XX_PULSE_0_NS / WS28XX_PULSE_1_NS cannot be told apart with WS28XX_SPI_SYMBOL bits"
+#	endif
+#	define WS28XX_SPI_SYMBOL_0 (((1U << WS28XX_SPI_HIGH_0) - 1) << (WS28XX_SPI_SYMBOL - WS28XX_SPI_HIGH_0))
+#	define WS28XX_SPI_SYMBOL_1 (((1U << WS28XX_SPI_HIGH_1) - 1) << (WS28XX_SPI_SYMBOL - WS28XX_SPI_HIGH_1))
+#endif
+
+#if (WS28XX_STREAM == true)
+#	define WS28XX_STREAM_HALF        (WS28XX_STREAM_PIXEL * WS28XX_PIXEL_SLOT)
+#endif
+
+#if (WS28XX_STATS == true)
+#	define WS28XX_CYCLE()            (DWT->CYCCNT) //@info Core clock cycles, differences stay valid across the wrap
+#endif
+
+#if (WS28XX_QUEUE > 0)
+//@info The ring words are plain uint32_t in ws28xx.h so C++ can include it, only this file accesses them atomically
+#	define WS28XX_ATOMIC(Word)       ((_Atomic uint32_t *)&(Word))
+_Static_assert((sizeof(_Atomic uint32_t) == sizeof(uint32_t)) && (_Alignof(_Atomic uint32_t) == _Alignof(uint32_t)), "_Atomic uint32_t must be laid out like uint32_t");
+#endif
+
+typedef struct {
+	uint16_t Length_Ns; //@info Bit time
+	uint16_t Pulse0_Ns; //@info High time of a 0
+	uint16_t Pulse1_Ns; //@info High time of a 1
+	uint32_t Reset_Ns;  //@info Shortest low time that latches a frame
+} WS28XX_TimingTypeDef;
+
+#if (WS28XX_MATRIX == true)
+typedef struct {
+	uint16_t X;      //@info Top left inside the matrix
+	uint16_t Y;
+	uint16_t Width;  //@info Columns and rows left inside the matrix
+	uint16_t Height;
+	uint16_t Skip_X; //@info Columns and rows of the rectangle cut off at its left and top
+	uint16_t Skip_Y;
+} WS28XX_RectTypeDef;
+#endif
+
+#if (WS28XX_INGEST == true)
+#	define WS28XX_INGEST_CHECK       0x55 //@info Adalight header checksum, count high ^ count low ^ 0x55
+
+typedef enum {
+	WS28XX_INGEST_MAGIC_A = 0, //@info Looking for "Ada"
+	WS28XX_INGEST_MAGIC_D,
+	WS28XX_INGEST_MAGIC_A2,
+	WS28XX_INGEST_COUNT_HIGH,  //@info LED count - 1, big endian
+	WS28XX_INGEST_COUNT_LOW,
+	WS28XX_INGEST_CHECKSUM,
+	WS28XX_INGEST_PAYLOAD,     //@info Red, green and blue of LED count pixels
+} WS28XX_IngestStateTypeDef;
+#endif
+
+#if (WS28XX_ANIMATION == true)
+#	define WS28XX_ANIM_U16(Byte)     ((uint16_t)((Byte)[0] | ((Byte)[1] << 8))) //@info Little endian, any alignment
+#endif
 
 /************************************************************************************************************
 **************    Private Variables
@@ -40,6 +208,52 @@ const uint8_t WS28XX_GammaTable[] = {0,   0,   0,   0,   0,   0,   0,   0,   0,
                                      191, 193, 194, 196, 198, 200, 202, 204, 206, 208, 210, 212, 214, 216, 218, 220, 222, 224, 227, 229, 231, 233, 235, 237, 239, 241, 244, 246, 248, 250, 252, 255};
 #endif
 
+//@info round(2^24 / n), turns the brightness scaling of WS28XX_Update into multiplications
+const uint32_t WS28XX_ReciprocalTable[] = {       0, 16777216,  8388608,  5592405,  4194304,  3355443,  2796203,  2396745,  2097152,  1864135,  1677722,  1525201,  1398101,  1290555,  1198373,  1118481,
+                                            1048576,   986895,   932068,   883011,   838861,   798915,   762601,   729444,   699051,   671089,   645278,   621378,   599186,   578525,   559241,   541201,
+                                             524288,   508400,   493448,   479349,   466034,   453438,   441506,   430185,   419430,   409200,   399458,   390168,   381300,   372827,   364722,   356962,
+                                             349525,   342392,   335544,   328965,   322639,   316551,   310689,   305040,   299593,   294337,   289262,   284360,   279620,   275036,   270600,   266305,
+                                             262144,   258111,   254200,   250406,   246724,   243148,   239675,   236299,   233017,   229825,   226719,   223696,   220753,   217886,   215093,   212370,
+                                             209715,   207126,   204600,   202135,   199729,   197379,   195084,   192842,   190650,   188508,   186414,   184365,   182361,   180400,   178481,   176602,
+                                             174763,   172961,   171196,   169467,   167772,   166111,   164483,   162886,   161319,   159783,   158276,   156796,   155345,   153919,   152520,   151146,
+                                             149797,   148471,   147169,   145889,   144631,   143395,   142180,   140985,   139810,   138655,   137518,   136400,   135300,   134218,   133153,   132104,
+                                             131072,   130056,   129056,   128070,   127100,   126144,   125203,   124276,   123362,   122461,   121574,   120699,   119837,   118987,   118149,   117323,
+                                             116508,   115705,   114912,   114131,   113360,   112599,   111848,   111107,   110376,   109655,   108943,   108240,   107546,   106861,   106185,   105517,
+                                             104858,   104206,   103563,   102928,   102300,   101680,   101068,   100462,    99864,    99273,    98690,    98112,    97542,    96978,    96421,    95870,
+                                              95325,    94787,    94254,    93727,    93207,    92692,    92183,    91679,    91181,    90688,    90200,    89718,    89241,    88768,    88301,    87839,
+                                              87381,    86929,    86480,    86037,    85598,    85164,    84733,    84308,    83886,    83469,    83056,    82646,    82241,    81840,    81443,    81049,
+                                              80660,    80274,    79892,    79513,    79138,    78766,    78398,    78034,    77672,    77314,    76960,    76608,    76260,    75915,    75573,    75234,
+                                              74898,    74565,    74235,    73908,    73584,    73263,    72944,    72629,    72316,    72005,    71698,    71392,    71090,    70790,    70493,    70198,
+                                              69905,    69615,    69327,    69042,    68759,    68478,    68200,    67924,    67650,    67378,    67109,    66841,    66576,    66313,    66052,    65793};
+
+//@info Datasheet timing of each WS28XX_ChipTypeDef, the shortest bit time whose high and low times are all inside
+//      the tolerances. WS2812B and WS2815 from revision 5 on latch after 280us, the older WS2812 after 50us
+static const WS28XX_TimingTypeDef WS28XX_Timing[] = {
+    [WS28XX_CHIP_CONF]    = {WS28XX_PULSE_LENGTH_NS, WS28XX_PULSE_0_NS, WS28XX_PULSE_1_NS, WS28XX_RESET_NS},
+    [WS28XX_CHIP_WS2811]  = {2500,                   500,               1200,              50000          },
+    [WS28XX_CHIP_WS2812]  = {1250,                   350,               700,               50000          },
+    [WS28XX_CHIP_WS2812B] = {1250,                   400,               800,               280000         },
+    [WS28XX_CHIP_WS2815]  = {1100,                   300,               800,               280000         },
+    [WS28XX_CHIP_SK6812]  = {1200,                   300,               600,               80000          },
+};
+
+#if (WS28XX_FRAMEBUFFER == true)
+//@info Byte of red, green and blue inside a pixel of each WS28XX_ORDER
+static const uint8_t WS28XX_OrderIndex[3][3] = {
+    [WS28XX_ORDER_RGB] = {0, 1, 2},
+    [WS28XX_ORDER_BGR] = {2, 1, 0},
+    [WS28XX_ORDER_GRB] = {1, 0, 2},
+};
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0)
+static uint8_t WS28XX_SpiTable[256][WS28XX_SPI_SYMBOL]; //@info SPI bytes of each byte value, built by WS28XX_Init_Spi
+#endif
+
+#if (WS28XX_GPIO_LANE > 0)
+static WS28XX_HandleTypeDef *WS28XX_GpioList; //@info Handles of WS28XX_Init_Gpio, searched by the DMA complete callback
+#endif
+
 /************************************************************************************************************
 **************    Private Functions
 ************************************************************************************************************/
@@ -47,6 +261,71 @@ const uint8_t WS28XX_GammaTable[] = {0,   0,   0,   0,   0,   0,   0,   0,   0,
 void WS28XX_Delay(uint32_t Delay);
 void WS28XX_Lock(WS28XX_HandleTypeDef *Handle);
 void WS28XX_UnLock(WS28XX_HandleTypeDef *Handle);
+void WS28XX_BuildPulseTable(WS28XX_HandleTypeDef *Handle);
+void WS28XX_InitPixel(WS28XX_HandleTypeDef *Handle, uint16_t Pixel);
+static inline void WS28XX_MarkDirty(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Last);
+static inline void WS28XX_StoreRGB(WS28XX_PixelTypeDef *Pixel, uint8_t Red, uint8_t Green, uint8_t Blue);
+static inline void WS28XX_FrameDone(WS28XX_HandleTypeDef *Handle);
+static inline WS28XX_SlotTypeDef *WS28XX_EncodeByte(const WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer, uint8_t Color);
+#if (WS28XX_FRAMEBUFFER == false)
+static inline void      WS28XX_ColorBytes(const WS28XX_HandleTypeDef *Handle, const WS28XX_PixelTypeDef Px, uint8_t *Byte);
+#endif
+static inline void      WS28XX_PixelBytes(const WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t *Byte);
+static inline WS28XX_SlotTypeDef *WS28XX_EncodePixel(const WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer, uint16_t Pixel);
+static inline uint8_t   WS28XX_Correct(const WS28XX_HandleTypeDef *Handle, uint8_t Channel, uint8_t Value);
+static inline uint8_t   WS28XX_MaxColor(const uint8_t *Color);
+#if (WS28XX_WHITE_EXTRACT == true)
+static inline void WS28XX_ExtractWhite(uint8_t *Value);
+#endif
+#if (WS28XX_COLOR_LUT == true)
+void WS28XX_BuildColorLut(WS28XX_HandleTypeDef *Handle);
+#endif
+#if (WS28XX_PALETTE > 0)
+static inline bool WS28XX_PaletteEntry(uint16_t Index);
+void WS28XX_BuildPalette(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count);
+void WS28XX_ReversePalette(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Last);
+#endif
+#if (WS28XX_DOUBLE_BUFFER == true)
+bool WS28XX_SendDraw(WS28XX_HandleTypeDef *Handle);
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+void WS28XX_EncodeBurst(WS28XX_HandleTypeDef *Handle);
+#endif
+#if (WS28XX_SPI_SYMBOL > 0)
+void WS28XX_BuildSpiTable(void);
+void WS28XX_EncodeSpi(WS28XX_HandleTypeDef *Handle);
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+void WS28XX_Transpose8(uint32_t Low, uint32_t High, uint8_t *Row);
+void WS28XX_EncodeGpio(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Last);
+bool WS28XX_StartGpio(WS28XX_HandleTypeDef *Handle);
+void WS28XX_GpioCpltCallback(DMA_HandleTypeDef *HDma);
+#endif
+#if (WS28XX_STREAM == true)
+void WS28XX_StreamEncode(WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer);
+void WS28XX_StreamNext(WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer, bool SecondHalf);
+#endif
+#if (WS28XX_QUEUE > 0)
+void WS28XX_InitQueue(WS28XX_HandleTypeDef *Handle);
+bool WS28XX_Post(WS28XX_HandleTypeDef *Handle, uint8_t Id, uint16_t First, uint16_t Count, uint8_t Value0, uint8_t Value1, uint8_t Value2);
+void WS28XX_Drain(WS28XX_HandleTypeDef *Handle);
+#endif
+#if (WS28XX_ANIMATION == true)
+uint32_t WS28XX_AnimDecode(WS28XX_HandleTypeDef *Handle, uint32_t Offset, bool Store);
+#endif
+#if (WS28XX_SCHEDULER == true)
+uint64_t WS28XX_FrameNs(const WS28XX_HandleTypeDef *Handle);
+#endif
+#if (WS28XX_MATRIX == true)
+static inline uint16_t WS28XX_LayoutIndex(uint8_t Layout, uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height);
+static inline bool     WS28XX_ClipRect(const WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, WS28XX_RectTypeDef *Rect);
+#endif
+#if (WS28XX_STATS == true)
+static inline void WS28XX_StatAdd(WS28XX_StatTypeDef *Stat, uint32_t Cycle);
+static inline void WS28XX_StatsEncode(WS28XX_HandleTypeDef *Handle, uint32_t Start);
+static inline void WS28XX_StatsSent(WS28XX_HandleTypeDef *Handle, bool Sent);
+static inline void WS28XX_StatsDone(WS28XX_HandleTypeDef *Handle);
+#endif
 
 /***********************************************************************************************************/
 
@@ -66,63 +345,2638 @@ void WS28XX_Delay(uint32_t Delay) {
 
 /***********************************************************************************************************/
 
-void WS28XX_Lock(WS28XX_HandleTypeDef *Handle) {
-	while (Handle->Lock) {
-		WS28XX_Delay(1);
+void WS28XX_Lock(WS28XX_HandleTypeDef *Handle) {
+#if (WS28XX_STATS == true)
+	uint32_t start = WS28XX_CYCLE();
+	bool     wait  = Handle->Lock;
+#endif
+	while (Handle->Lock) {
+		WS28XX_Delay(1);
+	}
+	Handle->Lock = 1;
+#if (WS28XX_STATS == true)
+	if (wait) {
+		WS28XX_StatAdd(&Handle->Stats_Lock, WS28XX_CYCLE() - start);
+	}
+#endif
+}
+
+/***********************************************************************************************************/
+
+void WS28XX_UnLock(WS28XX_HandleTypeDef *Handle) {
+	Handle->Lock = 0;
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_STATS == true)
+//@info Add a sample of Cycle cycles
+static inline void WS28XX_StatAdd(WS28XX_StatTypeDef *Stat, uint32_t Cycle) {
+	Stat->Min = (Cycle < Stat->Min) ? Cycle : Stat->Min;
+	Stat->Max = (Cycle > Stat->Max) ? Cycle : Stat->Max;
+	Stat->Count++;
+	Stat->Sum += Cycle;
+}
+
+/***********************************************************************************************************/
+
+//@info WS28XX_Update has encoded the frame since Start and starts the DMA next
+static inline void WS28XX_StatsEncode(WS28XX_HandleTypeDef *Handle, uint32_t Start) {
+	WS28XX_StatAdd(&Handle->Stats_Encode, WS28XX_CYCLE() - Start);
+}
+
+/***********************************************************************************************************/
+
+//@info The DMA of a frame was started, or the frame was dropped when Sent is false
+static inline void WS28XX_StatsSent(WS28XX_HandleTypeDef *Handle, bool Sent) {
+	if (Sent) {
+		Handle->Stats_Start = WS28XX_CYCLE();
+		Handle->Stats_Sent++;
+	} else {
+		Handle->Stats_Skipped++;
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info The frame is on the LEDs, called from the DMA callbacks right before WS28XX_FrameDoneCallback
+static inline void WS28XX_StatsDone(WS28XX_HandleTypeDef *Handle) {
+	uint32_t now    = WS28XX_CYCLE();
+	uint32_t window = now - Handle->Stats_Fps_Start;
+	WS28XX_StatAdd(&Handle->Stats_Transfer, now - Handle->Stats_Start);
+	Handle->Stats_Done++;
+	Handle->Stats_Fps_Frame++;
+	//@important a window longer than 2^32 cycles wraps, FPS then reads too high until the next window
+	if (window >= SystemCoreClock) {
+		Handle->Stats_Fps       = (uint32_t)(((uint64_t)Handle->Stats_Fps_Frame * SystemCoreClock * 100) / window);
+		Handle->Stats_Fps_Frame = 0;
+		Handle->Stats_Fps_Start = now;
+	}
+}
+
+/***********************************************************************************************************/
+#endif
+
+//@info Grow the dirty span so it covers First..Last
+static inline void WS28XX_MarkDirty(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Last) {
+	if (First < Handle->Dirty_First) {
+		Handle->Dirty_First = First;
+	}
+	if (Last > Handle->Dirty_Last) {
+		Handle->Dirty_Last = Last;
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info The frame and the latch time after it are sent, the end of every DMA callback. Every backend ends its
+//      frame with Reset_Slot low slots, so a frame started from here is never appended to the last one
+static inline void WS28XX_FrameDone(WS28XX_HandleTypeDef *Handle) {
+#if (WS28XX_SCHEDULER == true) && (WS28XX_DOUBLE_BUFFER == true)
+	//@info a queued frame was started by the callback and is on the wire now
+	Handle->Sched_Sending = Handle->Busy;
+#elif (WS28XX_SCHEDULER == true)
+	Handle->Sched_Sending = 0;
+#endif
+	WS28XX_FrameDoneCallback(Handle);
+}
+
+/***********************************************************************************************************/
+
+//@info Store a color like WS28XX_SetPixel_RGB, gamma and WS28XX_ORDER applied, the brightest channel as brightness
+static inline void WS28XX_StoreRGB(WS28XX_PixelTypeDef *Pixel, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	Pixel->Brightness = MAX_OF_THREE(Red, Green, Blue);
+#if (WS28XX_GAMMA == true)
+	Red   = WS28XX_GammaTable[Red];
+	Green = WS28XX_GammaTable[Green];
+	Blue  = WS28XX_GammaTable[Blue];
+#endif
+#if WS28XX_ORDER == WS28XX_ORDER_RGB
+	Pixel->Color[0] = Red;
+	Pixel->Color[1] = Green;
+	Pixel->Color[2] = Blue;
+#elif WS28XX_ORDER == WS28XX_ORDER_BGR
+	Pixel->Color[0] = Blue;
+	Pixel->Color[1] = Green;
+	Pixel->Color[2] = Red;
+#elif WS28XX_ORDER == WS28XX_ORDER_GRB
+	Pixel->Color[0] = Green;
+	Pixel->Color[1] = Red;
+	Pixel->Color[2] = Blue;
+#endif
+#if (WS28XX_COLOR_CHANNEL == 4)
+	Pixel->Color[3] = 0;
+#endif
+}
+
+/***********************************************************************************************************/
+
+void WS28XX_BuildPulseTable(WS28XX_HandleTypeDef *Handle) {
+#if (WS28XX_ENCODER_TABLE == true)
+	WS28XX_SlotTypeDef pulse[8];
+	for (uint16_t value = 0; value < 256; value++) {
+		for (uint8_t b = 0; b < 8; b++) {
+			pulse[b] = (value & (0x80 >> b)) ? Handle->Pulse1 : Handle->Pulse0;
+		}
+		memcpy(Handle->Pulse_Table[value], pulse, sizeof(pulse));
+	}
+#else
+	(void)Handle;
+#endif
+}
+
+/***********************************************************************************************************/
+
+//@info Clear the pixels and the pulse buffer and reset the color LUT, the part of the Init functions every backend shares
+void WS28XX_InitPixel(WS28XX_HandleTypeDef *Handle, uint16_t Pixel) {
+	Handle->Num_Pixel = Pixel;
+#if (WS28XX_FRAMEBUFFER == true)
+	Handle->Frame       = NULL;
+	Handle->Frame_Scale = 0x10000;
+#elif (WS28XX_EXTERNAL_BUFFER == true)
+	memset(Handle->Pixel, 0, Handle->Buffer_Pixel * sizeof(WS28XX_PixelStoreTypeDef));
+#else
+	memset(Handle->Pixel, 0, sizeof(Handle->Pixel));
+#endif
+#if (WS28XX_EXTERNAL_BUFFER == true)
+	memset(Handle->Buffer, 0, WS28XX_PULSE_BUFFER(Handle->Buffer_Pixel) * sizeof(WS28XX_SlotTypeDef));
+#else
+	memset(Handle->Buffer, 0, sizeof(Handle->Buffer));
+#endif
+	Handle->Dirty_First = 0xFFFF;
+	Handle->Dirty_Last  = 0;
+	WS28XX_Refresh(Handle);
+#if (WS28XX_COLOR_LUT == true)
+	Handle->Lut_Gamma      = 1.0f;
+	Handle->Lut_Brightness = 255;
+	memset(Handle->Lut_Correction, 255, sizeof(Handle->Lut_Correction));
+	WS28XX_BuildColorLut(Handle);
+#endif
+#if (WS28XX_PALETTE > 0)
+	//@info every pixel shows entry 0, all entries black
+	memset(Handle->Palette, 0, sizeof(Handle->Palette));
+	WS28XX_BuildPalette(Handle, 0, WS28XX_PALETTE);
+#endif
+#if (WS28XX_QUEUE > 0)
+	WS28XX_InitQueue(Handle);
+#endif
+#if (WS28XX_MATRIX == true)
+	Handle->Matrix_Map    = NULL;
+	Handle->Matrix_Width  = 0;
+	Handle->Matrix_Height = 0;
+#endif
+#if (WS28XX_INGEST == true)
+	Handle->Ingest_State = WS28XX_INGEST_MAGIC_A;
+	Handle->Ingest_Byte  = 0;
+	Handle->Ingest_Tail  = 0;
+	Handle->Ingest_Frame = 0;
+	Handle->Ingest_Error = 0;
+#endif
+#if (WS28XX_ANIMATION == true)
+	Handle->Anim_Data = NULL;
+#endif
+#if (WS28XX_SCHEDULER == true)
+	Handle->Sched_Fps   = 0;
+	Handle->Sched_Phase   = 0;
+	Handle->Sched_Late    = 0;
+	Handle->Sched_Sending = 0;
+#endif
+#if (WS28XX_STATS == true)
+	WS28XX_ResetStats(Handle);
+#endif
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_COLOR_LUT == true)
+//@info Fold gamma, global brightness and color correction into one table per channel, run only after a change
+void WS28XX_BuildColorLut(WS28XX_HandleTypeDef *Handle) {
+	for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+		float scale = (Handle->Lut_Brightness / 255.0f) * (Handle->Lut_Correction[ch] / 255.0f);
+		for (uint16_t value = 0; value < 256; value++) {
+			Handle->Lut[ch][value] = (uint8_t)((255.0f * powf((value / 255.0f) * scale, Handle->Lut_Gamma)) + 0.5f);
+		}
+	}
+	Handle->Lut_Changed = false;
+}
+
+/***********************************************************************************************************/
+#endif
+
+//@info Apply the color LUT of the channel, if enabled
+static inline uint8_t WS28XX_Correct(const WS28XX_HandleTypeDef *Handle, uint8_t Channel, uint8_t Value) {
+#if (WS28XX_COLOR_LUT == true)
+	return Handle->Lut[Channel][Value];
+#else
+	(void)Handle;
+	(void)Channel;
+	return Value;
+#endif
+}
+
+/***********************************************************************************************************/
+
+//@info Write the 8 pulses of one color byte, MSB first, and return the next free slot
+static inline WS28XX_SlotTypeDef *WS28XX_EncodeByte(const WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer, uint8_t Color) {
+#if (WS28XX_ENCODER_TABLE == true)
+	memcpy(Buffer, Handle->Pulse_Table[Color], sizeof(Handle->Pulse_Table[Color]));
+	return Buffer + 8;
+#else
+	for (int b = 7; b >= 0; b--) {
+		*Buffer++ = (Color & (1 << b)) ? Handle->Pulse1 : Handle->Pulse0;
+	}
+	return Buffer;
+#endif
+}
+
+/***********************************************************************************************************/
+
+//@info Brightest of the WS28XX_COLOR_CHANNEL channels of a pixel
+static inline uint8_t WS28XX_MaxColor(const uint8_t *Color) {
+	uint8_t max = MAX_OF_THREE(Color[0], Color[1], Color[2]);
+#if (WS28XX_COLOR_CHANNEL == 4)
+	if (Color[3] > max) {
+		max = Color[3];
+	}
+#endif
+	return max;
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_WHITE_EXTRACT == true)
+//@info Move the grey part min(R, G, B) of a color to the white LED, the sum saturates at 255
+static inline void WS28XX_ExtractWhite(uint8_t *Value) {
+	uint8_t  grey  = Value[0] < Value[1] ? Value[0] : Value[1];
+	uint16_t white;
+	grey  = (Value[2] < grey) ? Value[2] : grey;
+	white = Value[3] + grey;
+	Value[0] -= grey;
+	Value[1] -= grey;
+	Value[2] -= grey;
+	Value[3] = (white > 255) ? 255 : (uint8_t)white;
+}
+
+/***********************************************************************************************************/
+#endif
+
+//@info Write the WS28XX_COLOR_CHANNEL bytes of one pixel as they are sent, with its brightness, the white
+//      extraction and the color LUT applied
+#if (WS28XX_FRAMEBUFFER == true)
+//      The pixel is read from the frame of WS28XX_SetFrameBuffer, gamma is applied here instead of in the setters
+static inline void WS28XX_PixelBytes(const WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t *Byte) {
+	const uint8_t *src;
+	uint8_t        rgb[4] = {0};
+	if (Handle->Frame == NULL) {
+		src = rgb;
+	} else if (Handle->Frame_Format == WS28XX_FORMAT_565) {
+		uint16_t color = ((const uint16_t *)Handle->Frame)[Pixel];
+		rgb[0]         = (color >> 8) & 0xF8;
+		rgb[1]         = (color >> 3) & 0xFC;
+		rgb[2]         = (color << 3) & 0xF8;
+		src            = rgb;
+	} else if (Handle->Frame_Format == WS28XX_FORMAT_8888) {
+		src = (const uint8_t *)Handle->Frame + (Pixel * 4);
+	} else {
+		src = (const uint8_t *)Handle->Frame + (Pixel * 3);
+	}
+	Byte[0] = src[Handle->Frame_Map[0]];
+	Byte[1] = src[Handle->Frame_Map[1]];
+	Byte[2] = src[Handle->Frame_Map[2]];
+#	if (WS28XX_COLOR_CHANNEL == 4)
+	Byte[3] = (Handle->Frame_Format == WS28XX_FORMAT_8888) ? src[3] : 0;
+#	endif
+#	if (WS28XX_GAMMA == true)
+	{
+		//@info as the setters do it, gamma shapes the mix while the largest channel keeps its level
+		uint8_t level = WS28XX_MaxColor(Byte);
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			Byte[ch] = WS28XX_GammaTable[Byte[ch]];
+		}
+		uint8_t max = WS28XX_MaxColor(Byte);
+		if ((level != max) && (max != 0)) {
+			uint32_t scale = ((level * WS28XX_ReciprocalTable[max]) + 0x80) >> 8;
+			for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+				Byte[ch] = (uint8_t)(((Byte[ch] * scale) + 0x8000) >> 16);
+			}
+		}
+	}
+#	endif
+	if (Handle->Frame_Scale != 0x10000) {
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			Byte[ch] = (uint8_t)(((Byte[ch] * Handle->Frame_Scale) + 0x8000) >> 16);
+		}
+	}
+#	if (WS28XX_WHITE_EXTRACT == true)
+	WS28XX_ExtractWhite(Byte);
+#	endif
+	for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+		Byte[ch] = WS28XX_Correct(Handle, ch, Byte[ch]);
+	}
+}
+#else
+//      Px is a pixel, or a palette entry with WS28XX_PALETTE
+static inline void WS28XX_ColorBytes(const WS28XX_HandleTypeDef *Handle, const WS28XX_PixelTypeDef Px, uint8_t *Byte) {
+	uint8_t max = WS28XX_MaxColor(Px.Color);
+	if (Px.Brightness == max) {
+		//@info brightness of SetPixel_RGB/565/888, the color is sent as is
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			Byte[ch] = Px.Color[ch];
+		}
+	} else if ((Px.Brightness == 0) || (max == 0)) {
+		//@important with gamma enabled small colors become zero while the brightness stays non zero
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			Byte[ch] = 0;
+		}
+	} else {
+		//@important color * Brightness / max without division, scale is Brightness / max in 16.16 fixed point.
+		//           Brightness * table < 2^32 and color * scale < 2^32, the result is rounded to nearest
+		uint32_t scale = ((Px.Brightness * WS28XX_ReciprocalTable[max]) + 0x80) >> 8;
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			Byte[ch] = (uint8_t)(((Px.Color[ch] * scale) + 0x8000) >> 16);
+		}
+	}
+#	if (WS28XX_WHITE_EXTRACT == true)
+	WS28XX_ExtractWhite(Byte);
+#	endif
+	for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+		Byte[ch] = WS28XX_Correct(Handle, ch, Byte[ch]);
+	}
+}
+
+/***********************************************************************************************************/
+
+static inline void WS28XX_PixelBytes(const WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t *Byte) {
+#	if (WS28XX_PALETTE > 0)
+	//@info the entries are corrected when the palette changes, a pixel is one copy
+	memcpy(Byte, Handle->Palette_Byte[Handle->Pixel[Pixel]], WS28XX_COLOR_CHANNEL);
+#	else
+	WS28XX_ColorBytes(Handle, Handle->Pixel[Pixel], Byte);
+#	endif
+}
+#endif
+
+#if (WS28XX_PALETTE > 0)
+/***********************************************************************************************************/
+
+//@info Index is an entry of the palette, every uint8_t is with 256 entries
+static inline bool WS28XX_PaletteEntry(uint16_t Index) {
+	return Index < WS28XX_PALETTE;
+}
+
+/***********************************************************************************************************/
+
+//@info Correct Count entries from First into the bytes WS28XX_Update sends
+void WS28XX_BuildPalette(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count) {
+	for (uint16_t entry = First, last = First + Count; entry < last; entry++) {
+		WS28XX_ColorBytes(Handle, Handle->Palette[entry], Handle->Palette_Byte[entry]);
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Reverse the order of the entries First..Last, the step of WS28XX_RotatePalette
+void WS28XX_ReversePalette(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Last) {
+	while (First < Last) {
+		WS28XX_PixelTypeDef color = Handle->Palette[First];
+		uint8_t             byte[WS28XX_COLOR_CHANNEL];
+		memcpy(byte, Handle->Palette_Byte[First], WS28XX_COLOR_CHANNEL);
+		Handle->Palette[First] = Handle->Palette[Last];
+		memcpy(Handle->Palette_Byte[First], Handle->Palette_Byte[Last], WS28XX_COLOR_CHANNEL);
+		Handle->Palette[Last] = color;
+		memcpy(Handle->Palette_Byte[Last], byte, WS28XX_COLOR_CHANNEL);
+		First++;
+		Last--;
+	}
+}
+#endif
+
+/***********************************************************************************************************/
+
+//@info Write the WS28XX_PIXEL_SLOT pulses of one pixel with its brightness applied and return the next free slot
+static inline WS28XX_SlotTypeDef *WS28XX_EncodePixel(const WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer, uint16_t Pixel) {
+	uint8_t byte[WS28XX_COLOR_CHANNEL];
+	WS28XX_PixelBytes(Handle, Pixel, byte);
+	Buffer = WS28XX_EncodeByte(Handle, Buffer, byte[0]);
+	Buffer = WS28XX_EncodeByte(Handle, Buffer, byte[1]);
+#if (WS28XX_COLOR_CHANNEL == 4)
+	Buffer = WS28XX_EncodeByte(Handle, Buffer, byte[2]);
+	return WS28XX_EncodeByte(Handle, Buffer, byte[3]);
+#else
+	return WS28XX_EncodeByte(Handle, Buffer, byte[2]);
+#endif
+}
+
+#if (WS28XX_MULTI_CHANNEL > 1)
+/***********************************************************************************************************/
+
+//@info Encode the dirty span, each burst of Num_Strip slots holds one pulse of every strip in channel order
+void WS28XX_EncodeBurst(WS28XX_HandleTypeDef *Handle) {
+	WS28XX_SlotTypeDef pulse[WS28XX_PIXEL_SLOT];
+	uint8_t            stride = Handle->Num_Strip;
+	uint16_t           strip  = Handle->Dirty_First / Handle->Strip_Pixel;
+	uint16_t           index  = Handle->Dirty_First % Handle->Strip_Pixel;
+	for (uint32_t pixel = Handle->Dirty_First; pixel <= Handle->Dirty_Last; pixel++) {
+		WS28XX_SlotTypeDef *slot = &Handle->Buffer[((1 + (index * WS28XX_PIXEL_SLOT)) * stride) + strip];
+		WS28XX_EncodePixel(Handle, pulse, pixel);
+		for (uint8_t i = 0; i < WS28XX_PIXEL_SLOT; i++) {
+			slot[i * stride] = pulse[i];
+		}
+		if (++index == Handle->Strip_Pixel) {
+			index = 0;
+			strip++;
+		}
+	}
+}
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0)
+/***********************************************************************************************************/
+
+//@info Symbols of the 8 bits of every byte value, MSB first, split into WS28XX_SPI_SYMBOL bytes in sending order
+void WS28XX_BuildSpiTable(void) {
+	for (uint16_t value = 0; value < 256; value++) {
+		uint32_t bits = 0;
+		for (uint8_t b = 0; b < 8; b++) {
+			bits = (bits << WS28XX_SPI_SYMBOL) | ((value & (0x80 >> b)) ? WS28XX_SPI_SYMBOL_1 : WS28XX_SPI_SYMBOL_0);
+		}
+		for (uint8_t i = 0; i < WS28XX_SPI_SYMBOL; i++) {
+			WS28XX_SpiTable[value][i] = (uint8_t)(bits >> (8 * (WS28XX_SPI_SYMBOL - 1 - i)));
+		}
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Encode the dirty span, each color byte is one table lookup of WS28XX_SPI_SYMBOL bytes
+void WS28XX_EncodeSpi(WS28XX_HandleTypeDef *Handle) {
+	uint8_t *buffer = &Handle->Buffer[1 + (Handle->Dirty_First * WS28XX_COLOR_CHANNEL * WS28XX_SPI_SYMBOL)];
+	for (uint32_t pixel = Handle->Dirty_First; pixel <= Handle->Dirty_Last; pixel++) {
+		uint8_t byte[WS28XX_COLOR_CHANNEL];
+		WS28XX_PixelBytes(Handle, pixel, byte);
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			memcpy(buffer, WS28XX_SpiTable[byte[ch]], WS28XX_SPI_SYMBOL);
+			buffer += WS28XX_SPI_SYMBOL;
+		}
+	}
+}
+#endif
+
+#if (WS28XX_GPIO_LANE > 0)
+/***********************************************************************************************************/
+
+//@info 8x8 bit transpose of 8 lane bytes, lane n in byte n of Low (0 to 3) and High (4 to 7). Row[k] gets bit 7 - k
+//      of every lane, lane n in bit n. Swaps 1x1, 2x2 and 4x4 bit blocks with shifts and masks instead of 64 bit tests
+void WS28XX_Transpose8(uint32_t Low, uint32_t High, uint8_t *Row) {
+	uint32_t t;
+	t    = (Low ^ (Low >> 7)) & 0x00AA00AAU;
+	Low  = Low ^ t ^ (t << 7);
+	t    = (High ^ (High >> 7)) & 0x00AA00AAU;
+	High = High ^ t ^ (t << 7);
+	t    = (Low ^ (Low >> 14)) & 0x0000CCCCU;
+	Low  = Low ^ t ^ (t << 14);
+	t    = (High ^ (High >> 14)) & 0x0000CCCCU;
+	High = High ^ t ^ (t << 14);
+	t    = (Low & 0x0F0F0F0FU) | ((High << 4) & 0xF0F0F0F0U);
+	High = ((Low >> 4) & 0x0F0F0F0FU) | (High & 0xF0F0F0F0U);
+	Low  = t;
+	//@info byte k of Low holds bit k of every lane, byte k of High bit k + 4
+	Row[0] = (uint8_t)(High >> 24);
+	Row[1] = (uint8_t)(High >> 16);
+	Row[2] = (uint8_t)(High >> 8);
+	Row[3] = (uint8_t)High;
+	Row[4] = (uint8_t)(Low >> 24);
+	Row[5] = (uint8_t)(Low >> 16);
+	Row[6] = (uint8_t)(Low >> 8);
+	Row[7] = (uint8_t)Low;
+}
+
+/***********************************************************************************************************/
+
+//@info Encode pixels First to Last of every strip, one BSRR word per bit that resets the lanes sending a 0 at Pulse0
+void WS28XX_EncodeGpio(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Last) {
+	uint8_t   byte[WS28XX_COLOR_CHANNEL][WS28XX_GPIO_LANE];
+	uint8_t   row[WS28XX_GPIO_LANE / 8][8];
+	uint32_t *buffer = &Handle->Buffer[First * WS28XX_PIXEL_SLOT];
+	for (uint32_t index = First; index <= Last; index++) {
+		for (uint8_t lane = 0; lane < WS28XX_GPIO_LANE; lane++) {
+			uint8_t color[WS28XX_COLOR_CHANNEL];
+			WS28XX_PixelBytes(Handle, (lane * Handle->Strip_Pixel) + index, color);
+			for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+				byte[ch][lane] = color[ch];
+			}
+		}
+		for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+			for (uint8_t group = 0; group < WS28XX_GPIO_LANE / 8; group++) {
+				const uint8_t *lane = &byte[ch][group * 8];
+				WS28XX_Transpose8(lane[0] | (lane[1] << 8) | (lane[2] << 16) | ((uint32_t)lane[3] << 24),
+				                  lane[4] | (lane[5] << 8) | (lane[6] << 16) | ((uint32_t)lane[7] << 24), row[group]);
+			}
+			for (uint8_t bit = 0; bit < 8; bit++) {
+#if (WS28XX_GPIO_LANE == 16)
+				uint32_t one = row[0][bit] | (row[1][bit] << 8);
+#else
+				uint32_t one = row[0][bit];
+#endif
+				*buffer++ = (~one & Handle->Gpio_Set) << 16;
+			}
+		}
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Start the timer with three DMA requests on the port: the update sets every lane, channel 1 resets the lanes
+//      sending a 0 at Pulse0, channel 2 resets every lane at Pulse1
+bool WS28XX_StartGpio(WS28XX_HandleTypeDef *Handle) {
+	TIM_HandleTypeDef *htim   = Handle->HTim;
+	uintptr_t          bsrr   = (uintptr_t)&Handle->GPIOx->BSRR;
+	uint32_t           length = Handle->Strip_Pixel * WS28XX_PIXEL_SLOT;
+	if (Handle->Gpio_Busy != 0) {
+		return false;
+	}
+	__HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2);
+	htim->hdma[TIM_DMA_ID_CC2]->XferCpltCallback = WS28XX_GpioCpltCallback;
+	if ((HAL_DMA_Start(htim->hdma[TIM_DMA_ID_UPDATE], (uintptr_t)&Handle->Gpio_Set, bsrr, length) != HAL_OK) ||
+	    (HAL_DMA_Start(htim->hdma[TIM_DMA_ID_CC1], (uintptr_t)Handle->Buffer, bsrr, length) != HAL_OK) ||
+	    (HAL_DMA_Start_IT(htim->hdma[TIM_DMA_ID_CC2], (uintptr_t)&Handle->Gpio_Reset, bsrr, length) != HAL_OK)) {
+		return false;
+	}
+	//@important the first event must be the update, otherwise channel 1 writes the first bit before the lanes are set
+	__HAL_TIM_SET_COUNTER(htim, __HAL_TIM_GET_AUTORELOAD(htim));
+	__HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2);
+	Handle->Gpio_Busy = 1;
+	if (HAL_TIM_Base_Start(htim) != HAL_OK) {
+		__HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2);
+		Handle->Gpio_Busy = 0;
+		return false;
+	}
+	return true;
+}
+
+/***********************************************************************************************************/
+
+//@info DMA complete of channel 2, the last request of the frame. Channel 2 alone then keeps every lane low for
+//      Reset_Slot more periods, the frame is done when the LEDs have latched it
+void WS28XX_GpioCpltCallback(DMA_HandleTypeDef *HDma) {
+	for (WS28XX_HandleTypeDef *handle = WS28XX_GpioList; handle != NULL; handle = handle->Gpio_Next) {
+		if (handle->HTim == HDma->Parent) {
+			__HAL_TIM_DISABLE_DMA(handle->HTim, TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2);
+			if ((handle->Gpio_Busy == 1) && (handle->Reset_Slot > 0) &&
+			    (HAL_DMA_Start_IT(HDma, (uintptr_t)&handle->Gpio_Reset, (uintptr_t)&handle->GPIOx->BSRR, handle->Reset_Slot) == HAL_OK)) {
+				handle->Gpio_Busy = 2;
+				__HAL_TIM_ENABLE_DMA(handle->HTim, TIM_DMA_CC2);
+				return;
+			}
+			HAL_TIM_Base_Stop(handle->HTim);
+			handle->Gpio_Busy = 0;
+#	if (WS28XX_STATS == true)
+			WS28XX_StatsDone(handle);
+#	endif
+			WS28XX_FrameDone(handle);
+			return;
+		}
+	}
+}
+#endif
+
+#if (WS28XX_DOUBLE_BUFFER == true)
+/***********************************************************************************************************/
+
+//@info Start the DMA on the Draw buffer and draw the next frame into the other one, called with interrupts disabled
+bool WS28XX_SendDraw(WS28XX_HandleTypeDef *Handle) {
+	WS28XX_SlotTypeDef *front = Handle->Draw;
+	Handle->Pending = 0;
+	if (HAL_TIM_PWM_Start_DMA(Handle->HTim, Handle->Channel, (const uint32_t *)front, (Handle->Num_Pixel * WS28XX_PIXEL_SLOT) + 1 + Handle->Reset_Slot) != HAL_OK) {
+#	if (WS28XX_STATS == true)
+		WS28XX_StatsSent(Handle, false);
+#	endif
+		return false;
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsSent(Handle, true);
+#	endif
+	Handle->Busy = 1;
+	Handle->Draw = (front == Handle->Buffer) ? Handle->Buffer_Back : Handle->Buffer;
+	return true;
+}
+#endif
+
+#if (WS28XX_STREAM == true)
+/***********************************************************************************************************/
+
+//@info Encode the next chunk of WS28XX_STREAM_PIXEL pixels into one half of the buffer, slots after the last pixel stay low
+void WS28XX_StreamEncode(WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer) {
+	uint32_t pixel = (uint32_t)Handle->Stream_Chunk * WS28XX_STREAM_PIXEL;
+	uint32_t count = 0;
+	if (pixel < Handle->Num_Pixel) {
+		count = Handle->Num_Pixel - pixel;
+		if (count > WS28XX_STREAM_PIXEL) {
+			count = WS28XX_STREAM_PIXEL;
+		}
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		Buffer = WS28XX_EncodePixel(Handle, Buffer, pixel + i);
+	}
+	if (count < WS28XX_STREAM_PIXEL) {
+		memset(Buffer, 0, (WS28XX_STREAM_PIXEL - count) * WS28XX_PIXEL_SLOT * sizeof(WS28XX_SlotTypeDef));
+	}
+	Handle->Stream_Chunk++;
+}
+
+/***********************************************************************************************************/
+
+//@info Refill the half the DMA has just left, or stop when the last chunk of the frame has been sent
+void WS28XX_StreamNext(WS28XX_HandleTypeDef *Handle, WS28XX_SlotTypeDef *Buffer, bool SecondHalf) {
+	uint32_t remaining;
+	if ((uint16_t)(Handle->Stream_Chunk - 2) >= Handle->Stream_Last) {
+		HAL_TIM_PWM_Stop_DMA(Handle->HTim, Handle->Channel);
+		WS28XX_UnLock(Handle);
+#	if (WS28XX_STATS == true)
+		WS28XX_StatsDone(Handle);
+#	endif
+		WS28XX_FrameDone(Handle);
+		return;
+	}
+	WS28XX_StreamEncode(Handle, Buffer);
+	//@important the DMA must still be in the other half, otherwise it has already sent part of the old data
+	remaining = __HAL_DMA_GET_COUNTER(Handle->HTim->hdma[WS28XX_DMA_ID(Handle->Channel)]);
+	if (SecondHalf ? (remaining <= WS28XX_STREAM_HALF) : (remaining > WS28XX_STREAM_HALF)) {
+		Handle->Stream_Underrun++;
+	}
+}
+#endif
+
+#if (WS28XX_QUEUE > 0)
+/***********************************************************************************************************/
+
+//@info Empty the command ring, cell n is free for position n
+void WS28XX_InitQueue(WS28XX_HandleTypeDef *Handle) {
+	for (uint32_t i = 0; i < WS28XX_QUEUE; i++) {
+		atomic_store_explicit(WS28XX_ATOMIC(Handle->Queue[i].Sequence), i, memory_order_relaxed);
+	}
+	atomic_store_explicit(WS28XX_ATOMIC(Handle->Queue_Head), 0, memory_order_relaxed);
+	atomic_store_explicit(WS28XX_ATOMIC(Handle->Queue_Full), 0, memory_order_relaxed);
+	Handle->Queue_Tail = 0;
+}
+
+/***********************************************************************************************************/
+
+//@info Claim the cell of the next position with a compare and swap, write the command and publish it by its
+//      sequence. A producer interrupted in between only holds back the commands after its own, nobody waits
+bool WS28XX_Post(WS28XX_HandleTypeDef *Handle, uint8_t Id, uint16_t First, uint16_t Count, uint8_t Value0, uint8_t Value1, uint8_t Value2) {
+	WS28XX_CommandTypeDef *cell;
+	uint32_t               position = atomic_load_explicit(WS28XX_ATOMIC(Handle->Queue_Head), memory_order_relaxed);
+	for (;;) {
+		cell             = &Handle->Queue[position & (WS28XX_QUEUE - 1)];
+		int32_t distance = (int32_t)(atomic_load_explicit(WS28XX_ATOMIC(cell->Sequence), memory_order_acquire) - position);
+		if (distance == 0) {
+			if (atomic_compare_exchange_weak_explicit(WS28XX_ATOMIC(Handle->Queue_Head), &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (distance < 0) {
+			//@info the cell still holds a command of the previous lap, the ring is full
+			atomic_fetch_add_explicit(WS28XX_ATOMIC(Handle->Queue_Full), 1, memory_order_relaxed);
+			return false;
+		} else {
+			position = atomic_load_explicit(WS28XX_ATOMIC(Handle->Queue_Head), memory_order_relaxed);
+		}
+	}
+	cell->Id       = Id;
+	cell->First    = First;
+	cell->Count    = Count;
+	cell->Value[0] = Value0;
+	cell->Value[1] = Value1;
+	cell->Value[2] = Value2;
+	atomic_store_explicit(WS28XX_ATOMIC(cell->Sequence), position + 1, memory_order_release);
+	return true;
+}
+
+/***********************************************************************************************************/
+
+//@info Apply the published commands in order, called under the lock. Stops at a cell that is claimed but not
+//      written yet, the rest follows on the next call
+void WS28XX_Drain(WS28XX_HandleTypeDef *Handle) {
+	for (;;) {
+		WS28XX_CommandTypeDef *cell = &Handle->Queue[Handle->Queue_Tail & (WS28XX_QUEUE - 1)];
+		if (atomic_load_explicit(WS28XX_ATOMIC(cell->Sequence), memory_order_acquire) != Handle->Queue_Tail + 1) {
+			break;
+		}
+		switch (cell->Id) {
+			case WS28XX_COMMAND_PIXEL:
+				WS28XX_SetPixel_RGB(Handle, cell->First, cell->Value[0], cell->Value[1], cell->Value[2]);
+				break;
+			case WS28XX_COMMAND_FILL:
+				WS28XX_FillPixel_RGB(Handle, cell->First, cell->Count, cell->Value[0], cell->Value[1], cell->Value[2]);
+				break;
+			case WS28XX_COMMAND_BRIGHTNESS:
+				WS28XX_SetRangePixel_Brightness(Handle, cell->First, cell->Count, cell->Value[0]);
+				break;
+			default:
+				break;
+		}
+		//@info free the cell for the producers of the next lap
+		atomic_store_explicit(WS28XX_ATOMIC(cell->Sequence), Handle->Queue_Tail + WS28XX_QUEUE, memory_order_release);
+		Handle->Queue_Tail++;
+	}
+}
+#endif
+
+#if (WS28XX_MATRIX == true)
+/***********************************************************************************************************/
+
+//@info Position along the strip of X, Y in a Width x Height block wired in Layout
+static inline uint16_t WS28XX_LayoutIndex(uint8_t Layout, uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height) {
+	switch (Layout) {
+		case WS28XX_LAYOUT_SERPENTINE:
+			return (Y * Width) + ((Y & 1) ? (Width - 1 - X) : X);
+		case WS28XX_LAYOUT_COLUMN:
+			return (X * Height) + Y;
+		case WS28XX_LAYOUT_COLUMN_SERPENTINE:
+			return (X * Height) + ((X & 1) ? (Height - 1 - Y) : Y);
+		default:
+			return (Y * Width) + X;
+	}
+}
+
+/***********************************************************************************************************/
+
+//@info Cut the Width x Height rectangle at X, Y to the matrix, false when nothing of it is left
+static inline bool WS28XX_ClipRect(const WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, WS28XX_RectTypeDef *Rect) {
+	int32_t left   = (X < 0) ? 0 : X;
+	int32_t top    = (Y < 0) ? 0 : Y;
+	int32_t right  = (int32_t)X + Width;
+	int32_t bottom = (int32_t)Y + Height;
+	right          = (right > Handle->Matrix_Width) ? Handle->Matrix_Width : right;
+	bottom         = (bottom > Handle->Matrix_Height) ? Handle->Matrix_Height : bottom;
+	if ((Handle->Matrix_Map == NULL) || (left >= right) || (top >= bottom)) {
+		return false;
+	}
+	Rect->X      = (uint16_t)left;
+	Rect->Y      = (uint16_t)top;
+	Rect->Width  = (uint16_t)(right - left);
+	Rect->Height = (uint16_t)(bottom - top);
+	Rect->Skip_X = (uint16_t)(left - X);
+	Rect->Skip_Y = (uint16_t)(top - Y);
+	return true;
+}
+#endif
+
+#if (WS28XX_ANIMATION == true)
+/***********************************************************************************************************/
+
+//@info Decode the animation frame at Offset into the pixels and grow the dirty span by each of its spans, or only
+//      walk over it when Store is false. Returns the offset of the next frame, 0 when the frame runs out of the
+//      animation or off the strip
+uint32_t WS28XX_AnimDecode(WS28XX_HandleTypeDef *Handle, uint32_t Offset, bool Store) {
+	const uint8_t *src = &Handle->Anim_Data[Offset];
+	const uint8_t *end = &Handle->Anim_Data[Handle->Anim_Size];
+	uint16_t       span;
+	if ((end - src) < 2) {
+		return 0;
+	}
+	span = WS28XX_ANIM_U16(src) & ~WS28XX_ANIM_KEY;
+	src += 2;
+	while (span--) {
+		uint16_t first, count;
+		if ((end - src) < 4) {
+			return 0;
+		}
+		first = WS28XX_ANIM_U16(src);
+		count = WS28XX_ANIM_U16(src + 2);
+		src += 4;
+		if ((count == 0) || (((uint32_t)first + count) > Handle->Num_Pixel)) {
+			return 0;
+		}
+		if (Store) {
+			WS28XX_MarkDirty(Handle, first, first + count - 1);
+		}
+		for (uint32_t pixel = first, last = (uint32_t)first + count; pixel < last;) {
+			uint8_t  run;
+			uint32_t n;
+			if (src >= end) {
+				return 0;
+			}
+			run = *src++;
+			n   = (run & ~WS28XX_ANIM_RUN) + 1U;
+			if (n > (last - pixel)) {
+				return 0;
+			}
+			if (run & WS28XX_ANIM_RUN) {
+				if ((end - src) < 3) {
+					return 0;
+				}
+				if (Store) {
+					//@info one conversion, the other pixels of the run are copies
+					WS28XX_PixelTypeDef *dest = &Handle->Pixel[pixel];
+					WS28XX_StoreRGB(dest, src[0], src[1], src[2]);
+					for (WS28XX_PixelTypeDef *px = dest + 1, *stop = dest + n; px < stop; px++) {
+						*px = *dest;
+					}
+				}
+				src += 3;
+			} else {
+				if ((uint32_t)(end - src) < (n * 3)) {
+					return 0;
+				}
+				if (Store) {
+					WS28XX_PixelTypeDef *dest = &Handle->Pixel[pixel];
+					for (const uint8_t *stop = src + (n * 3); src < stop; src += 3, dest++) {
+						WS28XX_StoreRGB(dest, src[0], src[1], src[2]);
+					}
+				} else {
+					src += n * 3;
+				}
+			}
+			pixel += n;
+		}
+	}
+	return (uint32_t)(src - Handle->Anim_Data);
+}
+#endif
+
+/************************************************************************************************************
+**************    Public Functions
+************************************************************************************************************/
+
+#if (WS28XX_EXTERNAL_BUFFER == true)
+/**
+ * @brief  Set the buffers of a WS28XX handle
+ * @note   With WS28XX_EXTERNAL_BUFFER the handle holds no pixels, call this before the Init functions. The
+ *         buffers can be placed in any RAM the DMA reaches and are sized for Pixel pixels only, e.g.
+ *         static WS28XX_PixelTypeDef Pixel[10];
+ *         static WS28XX_SlotTypeDef  Pulse[WS28XX_PULSE_BUFFER(10)];
+ *         For WS28XX_Init_Multi and WS28XX_Init_Gpio, Pixel is the sum of all strips.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *PixelBuffer: Pixel array of Pixel elements, NULL with WS28XX_FRAMEBUFFER
+ * @param  *PulseBuffer: Pulse array of WS28XX_PULSE_BUFFER(Pixel) elements
+ * @param  Pixel: Largest number of pixels the Init functions may use
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetBuffer(WS28XX_HandleTypeDef *Handle, WS28XX_PixelStoreTypeDef *PixelBuffer, WS28XX_SlotTypeDef *PulseBuffer, uint16_t Pixel) {
+	bool answer = false;
+	do {
+		if ((Handle == NULL) || (PulseBuffer == NULL)) {
+			break;
+		}
+#	if (WS28XX_FRAMEBUFFER == false)
+		if (PixelBuffer == NULL) {
+			break;
+		}
+		Handle->Pixel = PixelBuffer;
+#	else
+		(void)PixelBuffer;
+#	endif
+#	if (WS28XX_STREAM == false)
+		//@important the pulses of one frame are sent by one DMA transfer, the SPI bytes too
+		if (WS28XX_BUFFER_SLOT((uint32_t)Pixel) > 65535) {
+			break;
+		}
+#	endif
+		Handle->Buffer       = PulseBuffer;
+		Handle->Buffer_Pixel = Pixel;
+#	if (WS28XX_DOUBLE_BUFFER == true)
+		Handle->Buffer_Back = PulseBuffer + WS28XX_BUFFER_SLOT(Pixel);
+#	endif
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+#endif
+
+/**
+ * @brief  Initialize WS28XX handle
+ * @note   Initialize WS28XX handle and set the Channel and number of Pixels, with the timing of ws2812b_conf.h
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *HTim: Pointer to TIM_HandleTypeDef structure
+ * @param  TimerBusFrequencyMHz: Frequency of timer bus frequency
+ * @param  Channel: Selected PWM channel
+ *         TIM_CHANNEL_1
+ *         TIM_CHANNEL_2
+ *         TIM_CHANNEL_3
+ *         TIM_CHANNEL_4
+ *         TIM_CHANNEL_5
+ *         TIM_CHANNEL_6
+ * @param  Pixel: Number of pixels
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Init(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Channel, uint16_t Pixel) {
+	return WS28XX_Init_Chip(Handle, HTim, TimerBusFrequencyMHz, Channel, Pixel, WS28XX_CHIP_CONF);
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Initialize WS28XX handle for a chip
+ * @note   Like WS28XX_Init, with the bit time, pulses and latch time of Chip. Handles on different timers can
+ *         drive different chips, e.g. a WS2811 strip at 400 kHz next to a WS2812B strip at 800 kHz.
+ *         With WS28XX_BYTE_PULSE the timer prescaler is raised until a bit takes at most 256 ticks, e.g. 1 at
+ *         216 MHz and 2 at 480 MHz, and the DMA of the channel must be set to byte memory and half-word
+ *         peripheral data width.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *HTim: Pointer to TIM_HandleTypeDef structure
+ * @param  TimerBusFrequencyMHz: Frequency of timer bus frequency
+ * @param  Channel: Selected PWM channel, TIM_CHANNEL_1 to TIM_CHANNEL_6
+ * @param  Pixel: Number of pixels
+ * @param  Chip: Timing profile
+ *         WS28XX_CHIP_CONF
+ *         WS28XX_CHIP_WS2811
+ *         WS28XX_CHIP_WS2812
+ *         WS28XX_CHIP_WS2812B
+ *         WS28XX_CHIP_WS2815
+ *         WS28XX_CHIP_SK6812
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Init_Chip(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Channel, uint16_t Pixel, WS28XX_ChipTypeDef Chip) {
+	bool                        answer    = false;
+	uint32_t                    prescaler = 0;
+	uint32_t                    aar_value;
+	const WS28XX_TimingTypeDef *timing;
+	do {
+		if (Handle == NULL || HTim == NULL) {
+			break;
+		}
+		if ((Pixel > WS28XX_CAPACITY(Handle)) || ((uint32_t)Chip >= (sizeof(WS28XX_Timing) / sizeof(WS28XX_Timing[0])))) {
+			break;
+		}
+		timing          = &WS28XX_Timing[Chip];
+		Handle->Channel = Channel;
+		Handle->HTim    = HTim;
+		aar_value       = (TimerBusFrequencyMHz / (1.0f / (timing->Length_Ns / 1000.0f))) - 1;
+#if (WS28XX_BYTE_PULSE == true)
+		//@info divide the timer clock until a bit takes at most 256 ticks, the smallest prescaler keeps the finest pulses
+		while ((aar_value > 255) && (prescaler < 0xFFFF)) {
+			prescaler++;
+			aar_value = ((TimerBusFrequencyMHz / (prescaler + 1.0f)) / (1.0f / (timing->Length_Ns / 1000.0f))) - 1;
+		}
+		if (aar_value > 255) {
+			break;
+		}
+		//@important the DMA reads one byte per slot and writes it as a half-word to the compare register
+		if ((HTim->hdma[WS28XX_DMA_ID(Channel)] == NULL) || (HTim->hdma[WS28XX_DMA_ID(Channel)]->Init.MemDataAlignment != DMA_MDATAALIGN_BYTE)) {
+			break;
+		}
+#endif
+		__HAL_TIM_SET_AUTORELOAD(Handle->HTim, aar_value);
+		__HAL_TIM_SET_PRESCALER(Handle->HTim, prescaler);
+		Handle->Pulse0     = ((timing->Pulse0_Ns / 1000.0f) * aar_value) / (timing->Length_Ns / 1000.0f);
+		Handle->Pulse1     = ((timing->Pulse1_Ns / 1000.0f) * aar_value) / (timing->Length_Ns / 1000.0f);
+		Handle->Reset_Slot = (timing->Reset_Ns + timing->Length_Ns - 1) / timing->Length_Ns;
+#if (WS28XX_SCHEDULER == true)
+		Handle->Slot_Ns = timing->Length_Ns;
+#endif
+		//@important the timer clock is too slow to tell a 0 from a 1
+		if ((Handle->Pulse0 == 0) || (Handle->Pulse1 <= Handle->Pulse0)) {
+			break;
+		}
+		WS28XX_BuildPulseTable(Handle);
+		WS28XX_InitPixel(Handle, Pixel);
+#if (WS28XX_STREAM == true)
+		//@important streaming needs the DMA of the channel in circular mode
+		if ((HTim->hdma[WS28XX_DMA_ID(Channel)] == NULL) || (HTim->hdma[WS28XX_DMA_ID(Channel)]->Init.Mode != DMA_CIRCULAR)) {
+			break;
+		}
+		Handle->Stream_Underrun = 0;
+#elif (WS28XX_BACKEND_PWM)
+		//@important a frame of low pulses, with WS28XX_DOUBLE_BUFFER its callback is the one that clears Busy
+		if (HAL_TIM_PWM_Start_DMA(Handle->HTim, Handle->Channel, (const uint32_t *)Handle->Buffer, (Pixel * WS28XX_PIXEL_SLOT) + 1 + Handle->Reset_Slot) != HAL_OK) {
+			break;
+		}
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+		Handle->Num_Strip = 1;
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1) || (WS28XX_GPIO_LANE > 0)
+		Handle->Strip_Pixel = Pixel;
+#endif
+#if (WS28XX_SPI_SYMBOL > 0)
+		Handle->HSpi = NULL;
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+		Handle->GPIOx = NULL;
+#endif
+#if (WS28XX_DOUBLE_BUFFER == true)
+		//@info Buffer is being sent above, both buffers need every pixel encoded once
+#	if (WS28XX_EXTERNAL_BUFFER == false)
+		memset(Handle->Buffer_Back, 0, sizeof(Handle->Buffer_Back));
+#	endif
+		Handle->Draw       = Handle->Buffer_Back;
+		Handle->Busy       = 1;
+		Handle->Pending    = 0;
+		Handle->Prev_First = Handle->Dirty_First;
+		Handle->Prev_Last  = Handle->Dirty_Last;
+#endif
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+#if (WS28XX_SPI_SYMBOL > 0)
+/***********************************************************************************************************/
+
+/**
+ * @brief  Initialize WS28XX handle on a SPI
+ * @note   Every WS28XX bit is sent as a WS28XX_SPI_SYMBOL bit symbol on MOSI, no timer is used. Set the SPI to
+ *         transmit only master, 8 bit, MSB first with a bit rate of WS28XX_SPI_SYMBOL / WS28XX_PULSE_LENGTH_NS
+ *         (2.4 MHz for 3 bit, 3.2 MHz for 4 bit symbols at 1250 ns), add a TX DMA request and forward
+ *         HAL_SPI_TxCpltCallback to WS28XX_SpiTxCpltCallback. Every frame ends with WS28XX_SPI_LATCH zero
+ *         bytes, so the transfer completes only after the latch time of the chips.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *HSpi: Pointer to SPI_HandleTypeDef structure
+ * @param  Pixel: Number of pixels
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Init_Spi(WS28XX_HandleTypeDef *Handle, SPI_HandleTypeDef *HSpi, uint16_t Pixel) {
+	bool answer = false;
+	do {
+		if (Handle == NULL || HSpi == NULL) {
+			break;
+		}
+		if (Pixel > WS28XX_CAPACITY(Handle)) {
+			break;
+		}
+		Handle->HTim       = NULL;
+		Handle->HSpi       = HSpi;
+		//@info the WS28XX_SPI_LATCH zero bytes closing every frame, in pulses
+		Handle->Reset_Slot = (WS28XX_SPI_LATCH * 8) / WS28XX_SPI_SYMBOL;
+#	if (WS28XX_SCHEDULER == true)
+		Handle->Slot_Ns = WS28XX_PULSE_LENGTH_NS;
+#	endif
+		WS28XX_BuildSpiTable();
+		WS28XX_InitPixel(Handle, Pixel);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+#endif
+
+#if (WS28XX_GPIO_LANE > 0)
+/***********************************************************************************************************/
+
+/**
+ * @brief  Initialize WS28XX handle for WS28XX_GPIO_LANE strips on one GPIO port
+ * @note   Strip n is on pin n of GPIOx, set the pins as push-pull outputs. HTim only paces the bits: set
+ *         channel 1 and 2 to output compare without output and add three memory to peripheral word DMA
+ *         requests, TIM_UP and TIM_CH2 without memory increment and TIM_CH1 with it. Enable the interrupt
+ *         of the TIM_CH2 DMA. The pixels of strip n are n * Pixel to (n + 1) * Pixel - 1 for the SetPixel
+ *         functions.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *HTim: Pointer to TIM_HandleTypeDef structure
+ * @param  TimerBusFrequencyMHz: Frequency of timer bus frequency
+ * @param  *GPIOx: Port of the strips
+ * @param  Pixel: Number of pixels of each strip
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Init_Gpio(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, GPIO_TypeDef *GPIOx, uint16_t Pixel) {
+	bool                   answer = false;
+	WS28XX_HandleTypeDef **list;
+	do {
+		if ((Handle == NULL) || (GPIOx == NULL) || (Pixel == 0)) {
+			break;
+		}
+		if (((uint32_t)WS28XX_GPIO_LANE * Pixel) > WS28XX_CAPACITY(Handle)) {
+			break;
+		}
+		if ((HTim == NULL) || (HTim->hdma[TIM_DMA_ID_UPDATE] == NULL) || (HTim->hdma[TIM_DMA_ID_CC1] == NULL) || (HTim->hdma[TIM_DMA_ID_CC2] == NULL)) {
+			break;
+		}
+		if (WS28XX_Init(Handle, HTim, TimerBusFrequencyMHz, TIM_CHANNEL_1, WS28XX_GPIO_LANE * Pixel) == false) {
+			break;
+		}
+		Handle->GPIOx       = GPIOx;
+		Handle->Strip_Pixel = Pixel;
+		Handle->Gpio_Set    = (1UL << WS28XX_GPIO_LANE) - 1;
+		Handle->Gpio_Reset  = Handle->Gpio_Set << 16;
+		Handle->Gpio_Busy   = 0;
+		GPIOx->BSRR         = Handle->Gpio_Reset;
+		__HAL_TIM_SET_COMPARE(HTim, TIM_CHANNEL_1, Handle->Pulse0);
+		__HAL_TIM_SET_COMPARE(HTim, TIM_CHANNEL_2, Handle->Pulse1);
+		for (list = &WS28XX_GpioList; (*list != NULL) && (*list != Handle); list = &(*list)->Gpio_Next) {
+		}
+		if (*list == NULL) {
+			Handle->Gpio_Next = NULL;
+			*list             = Handle;
+		}
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+#endif
+
+#if (WS28XX_MULTI_CHANNEL > 1)
+/***********************************************************************************************************/
+
+/**
+ * @brief  Initialize WS28XX handle for several strips on one timer
+ * @note   Strip n is driven by channel n + 1 of HTim, all of them are sent at once by one DMA burst on the
+ *         timer update event. Configure the update DMA request of the timer (TIM_UP) in CubeMX and forward
+ *         HAL_TIM_PeriodElapsedCallback to WS28XX_PeriodElapsedCallback. The pixels of strip n are
+ *         n * Pixel to (n + 1) * Pixel - 1 for the SetPixel functions.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *HTim: Pointer to TIM_HandleTypeDef structure
+ * @param  TimerBusFrequencyMHz: Frequency of timer bus frequency
+ * @param  Strip: Number of strips, 2 to WS28XX_MULTI_CHANNEL
+ * @param  Pixel: Number of pixels of each strip
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Init_Multi(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Strip, uint16_t Pixel) {
+	bool answer = false;
+	do {
+		if ((Handle == NULL) || (Strip < 2) || (Strip > WS28XX_MULTI_CHANNEL) || (Pixel == 0)) {
+			break;
+		}
+		if (((uint32_t)Strip * Pixel) > WS28XX_CAPACITY(Handle)) {
+			break;
+		}
+		if (WS28XX_Init(Handle, HTim, TimerBusFrequencyMHz, TIM_CHANNEL_1, Strip * Pixel) == false) {
+			break;
+		}
+		//@info the burst writes the compare registers, the channels only need their PWM output enabled
+		HAL_TIM_PWM_Stop_DMA(HTim, TIM_CHANNEL_1);
+		Handle->Num_Strip   = Strip;
+		Handle->Strip_Pixel = Pixel;
+		answer              = true;
+		for (uint8_t ch = 0; ch < Strip; ch++) {
+			if (HAL_TIM_PWM_Start(HTim, TIM_CHANNEL_1 + (ch * 4)) != HAL_OK) {
+				answer = false;
+			}
+		}
+	} while (0);
+
+	return answer;
+}
+#endif
+
+#if (WS28XX_FRAMEBUFFER == false) && (WS28XX_PALETTE == 0)
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel
+ * @note   Fill the pixel By RGB Values
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], Red, Green, Blue);
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel
+ * @note   Fill the pixel By RGB Values
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Color: RGB565 Color Code
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_RGB_565(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint16_t Color) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], (Color >> 8) & 0xF8, (Color >> 3) & 0xFC, (Color << 3) & 0xF8);
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel
+ * @note   Fill the pixel By RGB Values
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Color: RGB888 Color Code
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_RGB_888(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint32_t Color) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], (uint8_t)(Color >> 16), (uint8_t)(Color >> 8), (uint8_t)Color);
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+
+#	if (WS28XX_COLOR_CHANNEL == 4)
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel with white
+ * @note   Fill the pixel By RGB and White Values, for RGBW chips like the SK6812. White is sent after the
+ *         colors and the brightest of the four channels is the brightness.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ * @param  White: White Value, 0 to 255
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_RGB_White(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t White) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], Red, Green, Blue);
+#	if (WS28XX_GAMMA == true)
+		Handle->Pixel[Pixel].Color[3] = WS28XX_GammaTable[White];
+#	else
+		Handle->Pixel[Pixel].Color[3] = White;
+#	endif
+		if (White > Handle->Pixel[Pixel].Brightness) {
+			Handle->Pixel[Pixel].Brightness = White;
+		}
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+#	endif
+
+/***********************************************************************************************************/
+
+bool WS28XX_SetPixel_RGBW(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t Brightness) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], Red, Green, Blue);
+		Handle->Pixel[Pixel].Brightness = Brightness;
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel and Brightness
+ * @note   Fill the pixel By RGB Values
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Color: RGB565 Color Code
+ * @param  Brightness: Brightness level, 0 to 255
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_RGBW_565(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint16_t Color, uint8_t Brightness) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], (Color >> 8) & 0xF8, (Color >> 3) & 0xFC, (Color << 3) & 0xF8);
+		Handle->Pixel[Pixel].Brightness = Brightness;
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel and Brightness
+ * @note   Fill the pixel By RGB Values
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Color: RGB888 Color Code
+ * @param  Brightness: Brightness level, 0 to 255
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_RGBW_888(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint32_t Color, uint8_t Brightness) {
+	bool answer = true;
+	do {
+		if (Pixel >= Handle->Num_Pixel) {
+			answer = false;
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Pixel[Pixel], (uint8_t)(Color >> 16), (uint8_t)(Color >> 8), (uint8_t)Color);
+		Handle->Pixel[Pixel].Brightness = Brightness;
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+	} while (0);
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Fill pixels
+ * @note   Set Count pixels from First to one RGB color, like WS28XX_SetPixel_RGB on each of them
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip
+ */
+bool WS28XX_FillPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	bool                answer = false;
+	WS28XX_PixelTypeDef pixel;
+	do {
+		if ((Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+			break;
+		}
+		WS28XX_StoreRGB(&pixel, Red, Green, Blue);
+		for (WS28XX_PixelTypeDef *px = &Handle->Pixel[First], *end = px + Count; px < end; px++) {
+			*px = pixel;
+		}
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Copy pixels
+ * @note   Set Count pixels from First to the colors of an RGB888 image row, like WS28XX_SetPixel_RGB on each
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  *Rgb: 3 bytes per pixel, red first
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip
+ */
+bool WS28XX_CopyPixel_RGB_888(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint8_t *Rgb) {
+	bool answer = false;
+	do {
+		if ((Rgb == NULL) || (Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+			break;
+		}
+		for (WS28XX_PixelTypeDef *px = &Handle->Pixel[First], *end = px + Count; px < end; px++, Rgb += 3) {
+			WS28XX_StoreRGB(px, Rgb[0], Rgb[1], Rgb[2]);
+		}
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Copy pixels
+ * @note   Set Count pixels from First to RGB565 colors, like WS28XX_SetPixel_RGB_565 on each of them
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  *Color: RGB565 Color Codes
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip
+ */
+bool WS28XX_CopyPixel_RGB_565(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint16_t *Color) {
+	bool answer = false;
+	do {
+		if ((Color == NULL) || (Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+			break;
+		}
+		for (WS28XX_PixelTypeDef *px = &Handle->Pixel[First], *end = px + Count; px < end; px++, Color++) {
+			WS28XX_StoreRGB(px, (*Color >> 8) & 0xF8, (*Color >> 3) & 0xFC, (*Color << 3) & 0xF8);
+		}
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Copy pixels
+ * @note   Set Count pixels from First to colors that are already in WS28XX_ORDER, e.g. GRB for the WS2812B,
+ *         with the white byte last on RGBW chips. Gamma is applied when enabled, the brightest channel is
+ *         the brightness.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  *Color: WS28XX_COLOR_CHANNEL bytes per pixel
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip
+ */
+bool WS28XX_CopyPixel_Raw(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint8_t *Color) {
+	bool answer = false;
+	do {
+		if ((Color == NULL) || (Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+			break;
+		}
+		for (WS28XX_PixelTypeDef *px = &Handle->Pixel[First], *end = px + Count; px < end; px++, Color += WS28XX_COLOR_CHANNEL) {
+			px->Brightness = WS28XX_MaxColor(Color);
+			for (uint8_t ch = 0; ch < WS28XX_COLOR_CHANNEL; ch++) {
+#	if (WS28XX_GAMMA == true)
+				px->Color[ch] = WS28XX_GammaTable[Color[ch]];
+#	else
+				px->Color[ch] = Color[ch];
+#	endif
+			}
+		}
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+#elif (WS28XX_FRAMEBUFFER == true)
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set the frame of a WS28XX handle
+ * @note   With WS28XX_FRAMEBUFFER the handle holds no pixels, WS28XX_Update encodes straight from Frame. Gamma,
+ *         WS28XX_SetAllPixel_Brightness and the color LUT are applied while encoding. Call after the Init
+ *         functions and tell the library which pixels were redrawn with WS28XX_RefreshRange or WS28XX_Refresh.
+ *         With WS28XX_STREAM or WS28XX_DOUBLE_BUFFER, draw only between WS28XX_FrameDoneCallback and the next
+ *         WS28XX_Update, the frame is read while it is sent.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *Frame: Num_Pixel pixels of Format, NULL sends black
+ * @param  Format: Pixel format
+ *         WS28XX_FORMAT_888: 3 bytes per pixel in Order
+ *         WS28XX_FORMAT_8888: 4 bytes per pixel in Order, the last one is white on RGBW chips
+ *         WS28XX_FORMAT_565: uint16_t RGB565, Order is not used
+ * @param  Order: Byte order of the colors in Frame, WS28XX_ORDER_RGB, WS28XX_ORDER_BGR or WS28XX_ORDER_GRB
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetFrameBuffer(WS28XX_HandleTypeDef *Handle, const void *Frame, WS28XX_FormatTypeDef Format, uint8_t Order) {
+	bool answer = false;
+	do {
+		if ((Handle == NULL) || (Format > WS28XX_FORMAT_565) || (Order > WS28XX_ORDER_GRB)) {
+			break;
+		}
+		if (Format == WS28XX_FORMAT_565) {
+			Order = WS28XX_ORDER_RGB;
+		}
+		//@info channel n of the chip takes the frame byte holding the color WS28XX_ORDER sends at n
+		for (uint8_t color = 0; color < 3; color++) {
+			Handle->Frame_Map[WS28XX_OrderIndex[WS28XX_ORDER][color]] = WS28XX_OrderIndex[Order][color];
+		}
+		Handle->Frame        = Frame;
+		Handle->Frame_Format = Format;
+		WS28XX_Refresh(Handle);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+#else
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set Pixel
+ * @note   The pixel shows palette entry Index, WS28XX_Update sends the corrected color of the entry
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Number, 0 to Max - 1
+ * @param  Index: Palette entry, 0 to WS28XX_PALETTE - 1
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPixel_Index(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Index) {
+	bool answer = false;
+	do {
+		if ((Pixel >= Handle->Num_Pixel) || !WS28XX_PaletteEntry(Index)) {
+			break;
+		}
+		Handle->Pixel[Pixel] = Index;
+		WS28XX_MarkDirty(Handle, Pixel, Pixel);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Fill pixels
+ * @note   Set Count pixels from First to one palette entry
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  Index: Palette entry, 0 to WS28XX_PALETTE - 1
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip
+ */
+bool WS28XX_FillPixel_Index(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Index) {
+	bool answer = false;
+	do {
+		if ((Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel) || !WS28XX_PaletteEntry(Index)) {
+			break;
+		}
+		memset(&Handle->Pixel[First], Index, Count);
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Copy pixels
+ * @note   Set Count pixels from First to an array of palette entries, e.g. a row of an 8 bit indexed image
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  *Index: Count palette entries, 0 to WS28XX_PALETTE - 1
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip or an entry does not exist
+ */
+bool WS28XX_CopyPixel_Index(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint8_t *Index) {
+	bool answer = false;
+	do {
+		if ((Index == NULL) || (Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+			break;
+		}
+		//@info checked before the copy so nothing is written on a wrong entry, the loop is empty with 256 entries
+		uint16_t i = 0;
+		while ((i < Count) && WS28XX_PaletteEntry(Index[i])) {
+			i++;
+		}
+		if (i != Count) {
+			break;
+		}
+		memcpy(&Handle->Pixel[First], Index, Count);
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set a palette entry
+ * @note   Stored like WS28XX_SetPixel_RGB, gamma, WS28XX_ORDER and the brightest channel as brightness, then
+ *         corrected once for all the pixels that show it. Every pixel is encoded again by the next
+ *         WS28XX_Update.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Index: Palette entry, 0 to WS28XX_PALETTE - 1
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_SetPalette_RGB(WS28XX_HandleTypeDef *Handle, uint8_t Index, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	bool answer = false;
+	do {
+		if (!WS28XX_PaletteEntry(Index)) {
+			break;
+		}
+		WS28XX_StoreRGB(&Handle->Palette[Index], Red, Green, Blue);
+		WS28XX_BuildPalette(Handle, Index, 1);
+		WS28XX_Refresh(Handle);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Copy palette entries
+ * @note   Like WS28XX_SetPalette_RGB on Count entries from First
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First entry
+ * @param  Count: Number of entries
+ * @param  *Rgb: 3 bytes per entry, red first
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the palette
+ */
+bool WS28XX_CopyPalette_RGB_888(WS28XX_HandleTypeDef *Handle, uint8_t First, uint16_t Count, const uint8_t *Rgb) {
+	bool answer = false;
+	do {
+		if ((Rgb == NULL) || (Count == 0) || (((uint32_t)First + Count) > WS28XX_PALETTE)) {
+			break;
+		}
+		for (WS28XX_PixelTypeDef *entry = &Handle->Palette[First], *end = entry + Count; entry < end; entry++, Rgb += 3) {
+			WS28XX_StoreRGB(entry, Rgb[0], Rgb[1], Rgb[2]);
+		}
+		WS28XX_BuildPalette(Handle, First, Count);
+		WS28XX_Refresh(Handle);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Rotate palette entries
+ * @note   The colors of Count entries from First move Shift entries up, the last ones wrap around to First.
+ *         Color cycling costs Count entry moves instead of a write to every pixel, the corrected entries
+ *         move along and are not computed again. Shift Count - 1 moves them one entry down.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First entry
+ * @param  Count: Number of entries
+ * @param  Shift: Entries to move, taken modulo Count
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_RotatePalette(WS28XX_HandleTypeDef *Handle, uint8_t First, uint16_t Count, uint16_t Shift) {
+	bool answer = false;
+	do {
+		if ((Count == 0) || (((uint32_t)First + Count) > WS28XX_PALETTE)) {
+			break;
+		}
+		Shift %= Count;
+		answer = true;
+		if (Shift == 0) {
+			break;
+		}
+		//@info rotation by three reversals, in place without a copy of the palette on the stack
+		WS28XX_ReversePalette(Handle, First, First + Count - 1);
+		WS28XX_ReversePalette(Handle, First, First + Shift - 1);
+		WS28XX_ReversePalette(Handle, First + Shift, First + Count - 1);
+		WS28XX_Refresh(Handle);
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Crossfade palette entries
+ * @note   Set Count entries from First to the mix of two palettes, like WS28XX_CopyPalette_RGB_888. Call it
+ *         with a growing Amount for a fade that costs Count entries a frame, whatever the number of pixels.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First entry
+ * @param  Count: Number of entries
+ * @param  *From: 3 bytes per entry, red first
+ * @param  *To: 3 bytes per entry, red first
+ * @param  Amount: 0 is From, 255 is To
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the palette
+ */
+bool WS28XX_BlendPalette(WS28XX_HandleTypeDef *Handle, uint8_t First, uint16_t Count, const uint8_t *From, const uint8_t *To, uint8_t Amount) {
+	bool answer = false;
+	do {
+		if ((From == NULL) || (To == NULL) || (Count == 0) || (((uint32_t)First + Count) > WS28XX_PALETTE)) {
+			break;
+		}
+		for (WS28XX_PixelTypeDef *entry = &Handle->Palette[First], *end = entry + Count; entry < end; entry++, From += 3, To += 3) {
+			uint8_t rgb[3];
+			for (uint8_t c = 0; c < 3; c++) {
+				rgb[c] = (uint8_t)(((From[c] * (255U - Amount)) + (To[c] * Amount) + 127U) / 255U);
+			}
+			WS28XX_StoreRGB(entry, rgb[0], rgb[1], rgb[2]);
+		}
+		WS28XX_BuildPalette(Handle, First, Count);
+		WS28XX_Refresh(Handle);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+#endif
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Send Buffer to LEDs
+ * @note   This function use PWM+DMA for Sending data
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Update(WS28XX_HandleTypeDef *Handle) {
+	bool answer = true;
+	WS28XX_Lock(Handle);
+#if (WS28XX_STATS == true)
+	uint32_t start = WS28XX_CYCLE();
+#endif
+#if (WS28XX_QUEUE > 0)
+	WS28XX_Drain(Handle);
+#endif
+#if (WS28XX_SKIP_CLEAN_UPDATE == true)
+	//@info nothing changed since the last frame, the LEDs already show it
+	if (Handle->Dirty_First > Handle->Dirty_Last) {
+#	if (WS28XX_STATS == true)
+		Handle->Stats_Skipped++;
+#	endif
+		WS28XX_UnLock(Handle);
+		return answer;
+	}
+#endif
+#if (WS28XX_COLOR_LUT == true)
+	if (Handle->Lut_Changed) {
+		WS28XX_BuildColorLut(Handle);
+#	if (WS28XX_PALETTE > 0)
+		WS28XX_BuildPalette(Handle, 0, WS28XX_PALETTE);
+#	endif
+	}
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+	if (Handle->Num_Strip > 1) {
+		static const uint32_t burst_length[] = {TIM_DMABURSTLENGTH_1TRANSFER, TIM_DMABURSTLENGTH_2TRANSFERS, TIM_DMABURSTLENGTH_3TRANSFERS, TIM_DMABURSTLENGTH_4TRANSFERS};
+		uint16_t              first          = Handle->Dirty_First;
+		uint16_t              last           = Handle->Dirty_Last;
+		if (Handle->Dirty_First <= Handle->Dirty_Last) {
+			WS28XX_EncodeBurst(Handle);
+			Handle->Dirty_First = 0xFFFF;
+			Handle->Dirty_Last  = 0;
+		}
+#	if (WS28XX_STATS == true)
+		WS28XX_StatsEncode(Handle, start);
+#	endif
+		if (HAL_TIM_DMABurst_MultiWriteStart(Handle->HTim, TIM_DMABASE_CCR1, TIM_DMA_UPDATE, (const uint32_t *)Handle->Buffer, burst_length[Handle->Num_Strip - 1],
+		                                     ((Handle->Strip_Pixel * WS28XX_PIXEL_SLOT) + 1 + Handle->Reset_Slot) * Handle->Num_Strip) != HAL_OK) {
+			//@important the frame was not sent, the next WS28XX_Update sends these pixels again
+			WS28XX_MarkDirty(Handle, first, last);
+			answer = false;
+		}
+#	if (WS28XX_STATS == true)
+		WS28XX_StatsSent(Handle, answer);
+#	endif
+		WS28XX_UnLock(Handle);
+		return answer;
+	}
+#endif
+#if (WS28XX_STREAM == true)
+	uint16_t first       = Handle->Dirty_First;
+	uint16_t last        = Handle->Dirty_Last;
+	Handle->Dirty_First  = 0xFFFF;
+	Handle->Dirty_Last   = 0;
+	Handle->Stream_Chunk = 0;
+	Handle->Stream_Last  = ((Handle->Num_Pixel + WS28XX_STREAM_PIXEL - 1) / WS28XX_STREAM_PIXEL) + ((Handle->Reset_Slot + WS28XX_STREAM_HALF - 1) / WS28XX_STREAM_HALF) - 1;
+	WS28XX_StreamEncode(Handle, &Handle->Buffer[0]);
+	WS28XX_StreamEncode(Handle, &Handle->Buffer[WS28XX_STREAM_HALF]);
+#	if (WS28XX_STATS == true)
+	//@info only the first two chunks, the others are encoded by the DMA callbacks while the frame is sent
+	WS28XX_StatsEncode(Handle, start);
+#	endif
+	//@important the lock is released by WS28XX_PulseFinishedCallback when the frame and the reset time are sent
+	if (HAL_TIM_PWM_Start_DMA(Handle->HTim, Handle->Channel, (const uint32_t *)Handle->Buffer, WS28XX_STREAM_HALF * 2) != HAL_OK) {
+		//@important the frame was not sent, the next WS28XX_Update sends these pixels again
+		WS28XX_MarkDirty(Handle, first, last);
+		answer = false;
+		WS28XX_UnLock(Handle);
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsSent(Handle, answer);
+#	endif
+#elif (WS28XX_SPI_SYMBOL > 0)
+	if (Handle->HSpi == NULL) {
+		answer = false;
+	} else {
+		uint16_t first = Handle->Dirty_First;
+		uint16_t last  = Handle->Dirty_Last;
+		if (Handle->Dirty_First <= Handle->Dirty_Last) {
+			WS28XX_EncodeSpi(Handle);
+			Handle->Dirty_First = 0xFFFF;
+			Handle->Dirty_Last  = 0;
+		}
+#	if (WS28XX_STATS == true)
+		WS28XX_StatsEncode(Handle, start);
+#	endif
+		//@info the frame ends with WS28XX_SPI_LATCH zero bytes, the next one cannot start before the chips latched
+		if (HAL_SPI_Transmit_DMA(Handle->HSpi, Handle->Buffer, WS28XX_BUFFER_SLOT(Handle->Num_Pixel)) != HAL_OK) {
+			//@important the frame was not sent, the next WS28XX_Update sends these pixels again
+			WS28XX_MarkDirty(Handle, first, last);
+			answer = false;
+		}
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsSent(Handle, answer);
+#	endif
+	WS28XX_UnLock(Handle);
+#elif (WS28XX_GPIO_LANE > 0)
+	//@important the buffer is not encoded while the last frame or its latch time is on the lanes
+	if ((Handle->GPIOx == NULL) || (Handle->Gpio_Busy != 0)) {
+		answer = false;
+	} else {
+		uint16_t dirty_first = Handle->Dirty_First;
+		uint16_t dirty_last  = Handle->Dirty_Last;
+		if (Handle->Dirty_First <= Handle->Dirty_Last) {
+			//@info a span inside one strip is encoded as is, otherwise the same pixels of every strip are
+			uint16_t first = Handle->Dirty_First % Handle->Strip_Pixel;
+			uint16_t last  = Handle->Dirty_Last % Handle->Strip_Pixel;
+			if ((Handle->Dirty_First / Handle->Strip_Pixel) != (Handle->Dirty_Last / Handle->Strip_Pixel)) {
+				first = 0;
+				last  = Handle->Strip_Pixel - 1;
+			}
+			WS28XX_EncodeGpio(Handle, first, last);
+			Handle->Dirty_First = 0xFFFF;
+			Handle->Dirty_Last  = 0;
+		}
+#	if (WS28XX_STATS == true)
+		WS28XX_StatsEncode(Handle, start);
+#	endif
+		answer = WS28XX_StartGpio(Handle);
+		if (answer == false) {
+			//@important the frame was not sent, the next WS28XX_Update sends these pixels again
+			WS28XX_MarkDirty(Handle, dirty_first, dirty_last);
+		}
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsSent(Handle, answer);
+#	endif
+	WS28XX_UnLock(Handle);
+#elif (WS28XX_DOUBLE_BUFFER == true)
+	uint32_t primask = __get_PRIMASK();
+	uint16_t first   = Handle->Dirty_First;
+	uint16_t last    = Handle->Dirty_Last;
+	bool     pending;
+	//@important take back a frame still waiting in Draw, so the DMA callback cannot start it while it is encoded again
+	__disable_irq();
+	pending         = Handle->Pending;
+	Handle->Pending = 0;
+	__set_PRIMASK(primask);
+	if (pending) {
+#	if (WS28XX_STATS == true)
+		//@info the queued frame is replaced before it was sent
+		Handle->Stats_Skipped++;
+#	endif
+		//@info Draw is re-encoded, the other buffer now misses both spans
+		Handle->Prev_First = (first < Handle->Prev_First) ? first : Handle->Prev_First;
+		Handle->Prev_Last  = (last > Handle->Prev_Last) ? last : Handle->Prev_Last;
+	} else {
+		//@info Draw was encoded two frames ago, it misses the span encoded into the other buffer too
+		first              = (Handle->Prev_First < first) ? Handle->Prev_First : first;
+		last               = (Handle->Prev_Last > last) ? Handle->Prev_Last : last;
+		Handle->Prev_First = Handle->Dirty_First;
+		Handle->Prev_Last  = Handle->Dirty_Last;
+	}
+	if (first <= last) {
+		WS28XX_SlotTypeDef *buffer = &Handle->Draw[1 + (first * WS28XX_PIXEL_SLOT)];
+		for (uint32_t pixel = first; pixel <= last; pixel++) {
+			buffer = WS28XX_EncodePixel(Handle, buffer, pixel);
+		}
+	}
+	Handle->Dirty_First = 0xFFFF;
+	Handle->Dirty_Last  = 0;
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsEncode(Handle, start);
+#	endif
+	//@info send now when the DMA is idle, otherwise WS28XX_PulseFinishedCallback sends it after the current frame
+	__disable_irq();
+	if (Handle->Busy) {
+		Handle->Pending = 1;
+	} else {
+		answer = WS28XX_SendDraw(Handle);
+	}
+	__set_PRIMASK(primask);
+	if (answer == false) {
+		//@important Draw was not sent, the next WS28XX_Update encodes it again and sends it
+		WS28XX_MarkDirty(Handle, first, last);
+	}
+	WS28XX_UnLock(Handle);
+#else
+	//@info only the pixels changed since the last frame are encoded again, the rest of the buffer is still valid
+	uint16_t first = Handle->Dirty_First;
+	uint16_t last  = Handle->Dirty_Last;
+	if (Handle->Dirty_First <= Handle->Dirty_Last) {
+		WS28XX_SlotTypeDef *buffer = &Handle->Buffer[1 + (Handle->Dirty_First * WS28XX_PIXEL_SLOT)];
+		for (uint32_t pixel = Handle->Dirty_First; pixel <= Handle->Dirty_Last; pixel++) {
+			buffer = WS28XX_EncodePixel(Handle, buffer, pixel);
+		}
+		Handle->Dirty_First = 0xFFFF;
+		Handle->Dirty_Last  = 0;
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsEncode(Handle, start);
+#	endif
+
+	//@info the frame ends with Reset_Slot low slots, the transfer completes once the LEDs have latched it
+	if (HAL_TIM_PWM_Start_DMA(Handle->HTim, Handle->Channel, (const uint32_t *)Handle->Buffer, (Handle->Num_Pixel * WS28XX_PIXEL_SLOT) + 1 + Handle->Reset_Slot) != HAL_OK) {
+		//@important the frame was not sent, e.g. HAL_BUSY while the last one is still on the wire. Keep its
+		//           span so WS28XX_SKIP_CLEAN_UPDATE does not skip the next WS28XX_Update, merged with new changes
+		WS28XX_MarkDirty(Handle, first, last);
+		answer = false;
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsSent(Handle, answer);
+#	endif
+	WS28XX_UnLock(Handle);
+#endif
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Force a full refresh
+ * @note   Mark all pixels as changed, the next WS28XX_Update encodes and sends the whole strip
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ *
+ * @retval None
+ */
+void WS28XX_Refresh(WS28XX_HandleTypeDef *Handle) {
+	if (Handle->Num_Pixel > 0) {
+		WS28XX_MarkDirty(Handle, 0, Handle->Num_Pixel - 1);
+	}
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Refresh a range of pixels
+ * @note   Mark Count pixels from First as changed, e.g. after drawing them into the frame of
+ *         WS28XX_SetFrameBuffer. The next WS28XX_Update encodes them again.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_RefreshRange(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count) {
+	if ((Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+		return false;
+	}
+	WS28XX_MarkDirty(Handle, First, First + Count - 1);
+	return true;
+}
+
+/***********************************************************************************************************/
+
+#if (WS28XX_QUEUE > 0)
+/**
+ * @brief  Post a pixel color
+ * @note   The command is applied like WS28XX_SetPixel_RGB by the next WS28XX_Update, in the order of the posts.
+ *         It never blocks and can be called from interrupts and from any task while another one updates.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Pixel: Pixel Starts from 0 to Max - 1
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: false when the pixel is out of range or all WS28XX_QUEUE commands are waiting
+ */
+bool WS28XX_Post_Pixel(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	if (Pixel >= Handle->Num_Pixel) {
+		return false;
+	}
+	return WS28XX_Post(Handle, WS28XX_COMMAND_PIXEL, Pixel, 1, Red, Green, Blue);
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Post a range fill
+ * @note   The command is applied like WS28XX_FillPixel_RGB by the next WS28XX_Update, see WS28XX_Post_Pixel.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: false when the range is out of the strip or all WS28XX_QUEUE commands are waiting
+ */
+bool WS28XX_Post_Fill(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	if ((Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+		return false;
+	}
+	return WS28XX_Post(Handle, WS28XX_COMMAND_FILL, First, Count, Red, Green, Blue);
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Post a brightness change
+ * @note   The command is applied like WS28XX_SetRangePixel_Brightness by the next WS28XX_Update, see
+ *         WS28XX_Post_Pixel.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  Brightness: Brightness level, 0 to 255
+ *
+ * @retval bool: false when the range is out of the strip or all WS28XX_QUEUE commands are waiting
+ */
+bool WS28XX_Post_Brightness(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Brightness) {
+	if ((Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+		return false;
+	}
+	return WS28XX_Post(Handle, WS28XX_COMMAND_BRIGHTNESS, First, Count, Brightness, 0, 0);
+}
+
+/***********************************************************************************************************/
+#endif
+
+#if (WS28XX_MATRIX == true)
+/**
+ * @brief  Set the matrix of a WS28XX handle
+ * @note   Builds the strip index of every x, y once, the matrix functions then cost a table lookup per pixel.
+ *         Call after the Init functions. The matrix may cover only the first pixels of the strip.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *Map: Width * Height entries, owned by the application and kept until the next Init
+ * @param  *Matrix: Size, tiles, wiring and rotation of the matrix
+ *
+ * @retval bool: true or false, the handle keeps no matrix when the layout does not fit the strip
+ */
+bool WS28XX_SetMatrix(WS28XX_HandleTypeDef *Handle, uint16_t *Map, const WS28XX_MatrixTypeDef *Matrix) {
+	bool     answer = false;
+	uint16_t width, height;
+	do {
+		Handle->Matrix_Map = NULL;
+		if ((Map == NULL) || (Matrix == NULL) || (Matrix->Tile_Width == 0) || (Matrix->Tile_Height == 0) || (Matrix->Width % Matrix->Tile_Width != 0) ||
+		    (Matrix->Height % Matrix->Tile_Height != 0) || (Matrix->Layout > WS28XX_LAYOUT_COLUMN_SERPENTINE) ||
+		    (Matrix->Tile_Layout > WS28XX_LAYOUT_COLUMN_SERPENTINE) || (Matrix->Rotate > WS28XX_ROTATE_270)) {
+			break;
+		}
+		if ((Matrix->Width == 0) || (((uint32_t)Matrix->Width * Matrix->Height) > Handle->Num_Pixel)) {
+			break;
+		}
+		//@info x, y of the image run over the rotated size
+		width  = ((Matrix->Rotate == WS28XX_ROTATE_90) || (Matrix->Rotate == WS28XX_ROTATE_270)) ? Matrix->Height : Matrix->Width;
+		height = ((Matrix->Rotate == WS28XX_ROTATE_90) || (Matrix->Rotate == WS28XX_ROTATE_270)) ? Matrix->Width : Matrix->Height;
+		for (uint16_t y = 0; y < height; y++) {
+			for (uint16_t x = 0; x < width; x++) {
+				uint16_t px, py, tile, in;
+				switch (Matrix->Rotate) {
+					case WS28XX_ROTATE_90:
+						px = Matrix->Width - 1 - y;
+						py = x;
+						break;
+					case WS28XX_ROTATE_180:
+						px = Matrix->Width - 1 - x;
+						py = Matrix->Height - 1 - y;
+						break;
+					case WS28XX_ROTATE_270:
+						px = y;
+						py = Matrix->Height - 1 - x;
+						break;
+					default:
+						px = x;
+						py = y;
+						break;
+				}
+				tile = WS28XX_LayoutIndex(Matrix->Tile_Layout, px / Matrix->Tile_Width, py / Matrix->Tile_Height, Matrix->Width / Matrix->Tile_Width,
+				                          Matrix->Height / Matrix->Tile_Height);
+				in   = WS28XX_LayoutIndex(Matrix->Layout, px % Matrix->Tile_Width, py % Matrix->Tile_Height, Matrix->Tile_Width, Matrix->Tile_Height);
+				Map[(y * width) + x] = (uint16_t)((tile * Matrix->Tile_Width * Matrix->Tile_Height) + in);
+			}
+		}
+		Handle->Matrix_Map    = Map;
+		Handle->Matrix_Width  = width;
+		Handle->Matrix_Height = height;
+		answer                = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set matrix pixel
+ * @note   Like WS28XX_SetPixel_RGB on the strip pixel at X, Y
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  X: Column from the left, 0 to Matrix_Width - 1
+ * @param  Y: Row from the top, 0 to Matrix_Height - 1
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Matrix_SetPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t X, uint16_t Y, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	bool     answer = false;
+	uint16_t index;
+	do {
+		if ((Handle->Matrix_Map == NULL) || (X >= Handle->Matrix_Width) || (Y >= Handle->Matrix_Height)) {
+			break;
+		}
+		index = Handle->Matrix_Map[(Y * Handle->Matrix_Width) + X];
+		WS28XX_StoreRGB(&Handle->Pixel[index], Red, Green, Blue);
+		WS28XX_MarkDirty(Handle, index, index);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Fill matrix rectangle
+ * @note   Set the pixels of a rectangle to one color, the part outside the matrix is cut off
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  X: Left column, may be negative
+ * @param  Y: Top row, may be negative
+ * @param  Width: Columns
+ * @param  Height: Rows
+ * @param  Red: Red Value, 0 to 255
+ * @param  Green: Green Value, 0 to 255
+ * @param  Blue: Blue Value, 0 to 255
+ *
+ * @retval bool: true or false, false when no pixel of the rectangle is on the matrix
+ */
+bool WS28XX_Matrix_FillRect_RGB(WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	bool                 answer = false;
+	WS28XX_RectTypeDef   rect;
+	WS28XX_PixelTypeDef  pixel;
+	WS28XX_PixelTypeDef *dest  = &Handle->Pixel[0]; //@info kept in a register, the stores could alias the handle
+	uint16_t             first = 0xFFFF, last = 0;
+	do {
+		if (WS28XX_ClipRect(Handle, X, Y, Width, Height, &rect) == false) {
+			break;
+		}
+		WS28XX_StoreRGB(&pixel, Red, Green, Blue);
+		for (uint16_t y = 0; y < rect.Height; y++) {
+			const uint16_t *map = &Handle->Matrix_Map[((rect.Y + y) * Handle->Matrix_Width) + rect.X];
+			for (const uint16_t *end = map + rect.Width; map < end; map++) {
+				dest[*map] = pixel;
+				first               = (*map < first) ? *map : first;
+				last                = (*map > last) ? *map : last;
+			}
+		}
+		WS28XX_MarkDirty(Handle, first, last);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Fill matrix span
+ * @note   Set Length pixels of row Y from column X on to one color, see WS28XX_Matrix_FillRect_RGB
+ *
+ * @retval bool: true or false, false when no pixel of the span is on the matrix
+ */
+bool WS28XX_Matrix_FillSpan_RGB(WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Length, uint8_t Red, uint8_t Green, uint8_t Blue) {
+	return WS28XX_Matrix_FillRect_RGB(Handle, X, Y, Length, 1, Red, Green, Blue);
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Blit image
+ * @note   Draw a row by row RGB888 image with its top left at X, Y in one pass over the map, like
+ *         WS28XX_Matrix_SetPixel_RGB on every pixel. The part outside the matrix is cut off.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  X: Left column, may be negative
+ * @param  Y: Top row, may be negative
+ * @param  Width: Columns of the image
+ * @param  Height: Rows of the image
+ * @param  *Rgb: Width * Height * 3 bytes, red first
+ *
+ * @retval bool: true or false, false when no pixel of the image is on the matrix
+ */
+bool WS28XX_Matrix_Blit_RGB_888(WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const uint8_t *Rgb) {
+	bool                 answer = false;
+	WS28XX_RectTypeDef   rect;
+	WS28XX_PixelTypeDef *dest  = &Handle->Pixel[0]; //@info kept in a register, the byte stores could alias the map
+	uint16_t             first = 0xFFFF, last = 0;
+	do {
+		if ((Rgb == NULL) || (WS28XX_ClipRect(Handle, X, Y, Width, Height, &rect) == false)) {
+			break;
+		}
+		for (uint16_t y = 0; y < rect.Height; y++) {
+			const uint16_t *map = &Handle->Matrix_Map[((rect.Y + y) * Handle->Matrix_Width) + rect.X];
+			const uint8_t  *src = &Rgb[((((rect.Skip_Y + y) * Width) + rect.Skip_X) * 3)];
+			for (const uint16_t *end = map + rect.Width; map < end; map++, src += 3) {
+				WS28XX_StoreRGB(&dest[*map], src[0], src[1], src[2]);
+				first = (*map < first) ? *map : first;
+				last  = (*map > last) ? *map : last;
+			}
+		}
+		WS28XX_MarkDirty(Handle, first, last);
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+#endif
+
+#if (WS28XX_INGEST == true)
+/**
+ * @brief  Receive Adalight frames
+ * @note   Parses "Ada", the LED count - 1 (big endian), the header checksum (count high ^ count low ^ 0x55) and
+ *         3 bytes per LED, red first, as Prismatik, Hyperion or Ambibox send them. Whole pixels are stored
+ *         straight from Data like WS28XX_SetPixel_RGB, only a pixel split between two calls is held in the
+ *         handle, so bytes can be passed in any pieces as they arrive. Pixels past the strip are dropped. A
+ *         header with a wrong checksum is counted in Ingest_Error and the search for the next "Ada" goes on.
+ *         At the end of each frame WS28XX_Update is called, in the context of the caller. While
+ *         WS28XX_SetFrameRate runs, the frame is left to WS28XX_Tick instead, so an interrupt can feed the
+ *         parser without encoding.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *Data: Received bytes
+ * @param  Length: Number of bytes
+ *
+ * @retval uint16_t: Frames completed by these bytes
+ */
+uint16_t WS28XX_Ingest(WS28XX_HandleTypeDef *Handle, const uint8_t *Data, uint32_t Length) {
+	uint16_t       frame = 0;
+	const uint8_t *end   = Data + Length;
+	if ((Handle == NULL) || (Data == NULL)) {
+		return 0;
+	}
+	while (Data < end) {
+		if (Handle->Ingest_State == WS28XX_INGEST_PAYLOAD) {
+			uint32_t pixel = Handle->Ingest_Pixel;
+			if ((Handle->Ingest_Byte == 0) && ((end - Data) >= 3)) {
+				//@info every whole pixel at hand in one pass, as many as the frame still has
+				uint32_t count = (uint32_t)(end - Data) / 3;
+				uint32_t store = 0;
+				if (count > ((uint32_t)Handle->Ingest_Last + 1 - pixel)) {
+					count = (uint32_t)Handle->Ingest_Last + 1 - pixel;
+				}
+				if (pixel < Handle->Num_Pixel) {
+					store = ((pixel + count) > Handle->Num_Pixel) ? (Handle->Num_Pixel - pixel) : count;
+				}
+				if (store > 0) {
+					WS28XX_PixelTypeDef *dest = &Handle->Pixel[pixel];
+					for (const uint8_t *stop = Data + (store * 3); Data < stop; Data += 3, dest++) {
+						WS28XX_StoreRGB(dest, Data[0], Data[1], Data[2]);
+					}
+					WS28XX_MarkDirty(Handle, pixel, pixel + store - 1);
+				}
+				Data  += (count - store) * 3;
+				pixel += count;
+			} else if (Handle->Ingest_Byte < 2) {
+				Handle->Ingest_Rgb[Handle->Ingest_Byte++] = *Data++;
+			} else {
+				if (pixel < Handle->Num_Pixel) {
+					WS28XX_StoreRGB(&Handle->Pixel[pixel], Handle->Ingest_Rgb[0], Handle->Ingest_Rgb[1], *Data);
+					WS28XX_MarkDirty(Handle, pixel, pixel);
+				}
+				Data++;
+				Handle->Ingest_Byte = 0;
+				pixel++;
+			}
+			Handle->Ingest_Pixel = pixel;
+			if (pixel > Handle->Ingest_Last) {
+				Handle->Ingest_State = WS28XX_INGEST_MAGIC_A;
+				Handle->Ingest_Frame++;
+				frame++;
+#	if (WS28XX_SCHEDULER == true)
+				if (Handle->Sched_Fps == 0) {
+					WS28XX_Update(Handle);
+				}
+#	else
+				WS28XX_Update(Handle);
+#	endif
+			}
+			continue;
+		}
+		uint8_t byte = *Data++;
+		switch (Handle->Ingest_State) {
+			case WS28XX_INGEST_MAGIC_A:
+				Handle->Ingest_State = (byte == 'A') ? WS28XX_INGEST_MAGIC_D : WS28XX_INGEST_MAGIC_A;
+				break;
+			case WS28XX_INGEST_MAGIC_D:
+				Handle->Ingest_State = (byte == 'd') ? WS28XX_INGEST_MAGIC_A2 : ((byte == 'A') ? WS28XX_INGEST_MAGIC_D : WS28XX_INGEST_MAGIC_A);
+				break;
+			case WS28XX_INGEST_MAGIC_A2:
+				Handle->Ingest_State = (byte == 'a') ? WS28XX_INGEST_COUNT_HIGH : ((byte == 'A') ? WS28XX_INGEST_MAGIC_D : WS28XX_INGEST_MAGIC_A);
+				break;
+			case WS28XX_INGEST_COUNT_HIGH:
+				Handle->Ingest_Last  = (uint16_t)(byte << 8);
+				Handle->Ingest_State = WS28XX_INGEST_COUNT_LOW;
+				break;
+			case WS28XX_INGEST_COUNT_LOW:
+				Handle->Ingest_Last |= byte;
+				Handle->Ingest_State = WS28XX_INGEST_CHECKSUM;
+				break;
+			default:
+				if (byte == ((Handle->Ingest_Last >> 8) ^ (Handle->Ingest_Last & 0xFF) ^ WS28XX_INGEST_CHECK)) {
+					Handle->Ingest_Pixel = 0;
+					Handle->Ingest_Byte  = 0;
+					Handle->Ingest_State = WS28XX_INGEST_PAYLOAD;
+				} else {
+					Handle->Ingest_Error++;
+					Handle->Ingest_State = WS28XX_INGEST_MAGIC_A;
+				}
+				break;
+		}
+	}
+
+	return frame;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Receive Adalight frames from a circular DMA buffer
+ * @note   Passes the bytes from the last call up to Head to WS28XX_Ingest, in two pieces when they wrap. Head
+ *         is the position the DMA writes next, Size - __HAL_DMA_GET_COUNTER() or the Size argument of
+ *         HAL_UARTEx_RxEventCallback. Call it before the DMA has written Size more bytes, e.g. from the half,
+ *         complete and idle events of the UART.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *Ring: Receive buffer of the DMA in circular mode
+ * @param  Size: Bytes of Ring
+ * @param  Head: Next byte the DMA writes, 0 to Size. Size reads up to the end of Ring
+ *
+ * @retval uint16_t: Frames completed by the new bytes
+ */
+uint16_t WS28XX_Ingest_Ring(WS28XX_HandleTypeDef *Handle, const uint8_t *Ring, uint16_t Size, uint16_t Head) {
+	uint16_t frame = 0;
+	uint16_t tail;
+	if ((Handle == NULL) || (Ring == NULL) || (Size == 0) || (Head > Size)) {
+		return 0;
+	}
+	tail = (Handle->Ingest_Tail < Size) ? Handle->Ingest_Tail : 0;
+	if (Head < tail) {
+		frame += WS28XX_Ingest(Handle, &Ring[tail], Size - tail);
+		tail = 0;
+	}
+	frame += WS28XX_Ingest(Handle, &Ring[tail], Head - tail);
+	Handle->Ingest_Tail = (Head == Size) ? 0 : Head;
+
+	return frame;
+}
+
+/***********************************************************************************************************/
+#endif
+
+#if (WS28XX_ANIMATION == true)
+/**
+ * @brief  Set the animation of a WS28XX handle
+ * @note   Data holds the format described at WS28XX_ANIM_MAGIC in ws28xx.h, e.g. made by host/anim.c from raw
+ *         RGB frames. It is read in place, from RAM or memory mapped flash, and must stay until the next Init.
+ *         The first frame must be a keyframe. Call after the Init functions.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *Data: The animation
+ * @param  Size: Bytes of Data
+ *
+ * @retval bool: true or false, the handle keeps no animation when the header does not fit the strip
+ */
+bool WS28XX_SetAnimation(WS28XX_HandleTypeDef *Handle, const uint8_t *Data, uint32_t Size) {
+	bool answer = false;
+	do {
+		Handle->Anim_Data = NULL;
+		if ((Data == NULL) || (Size < (WS28XX_ANIM_HEADER + 2)) || (memcmp(Data, WS28XX_ANIM_MAGIC, 4) != 0)) {
+			break;
+		}
+		if ((WS28XX_ANIM_U16(&Data[4]) > Handle->Num_Pixel) || (WS28XX_ANIM_U16(&Data[6]) == 0)) {
+			break;
+		}
+		if ((WS28XX_ANIM_U16(&Data[WS28XX_ANIM_HEADER]) & WS28XX_ANIM_KEY) == 0) {
+			break;
+		}
+		Handle->Anim_Size      = Size;
+		Handle->Anim_Next      = WS28XX_ANIM_HEADER;
+		Handle->Anim_Frame     = 0;
+		Handle->Anim_Num_Frame = WS28XX_ANIM_U16(&Data[6]);
+		Handle->Anim_Fps       = WS28XX_ANIM_U16(&Data[8]);
+		Handle->Anim_Data      = Data;
+		answer                 = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Next animation frame
+ * @note   Decodes the next frame of WS28XX_SetAnimation into the pixels, like WS28XX_SetPixel_RGB, and grows the
+ *         dirty span by the pixels it changes, so the next WS28XX_Update only encodes those. Runs of one color
+ *         are converted once. After the last frame the first one follows.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ *
+ * @retval bool: true or false, on a frame that runs out of the animation or off the strip the pixels decoded
+ *         before it stay and the animation does not move on
+ */
+bool WS28XX_Animation_Next(WS28XX_HandleTypeDef *Handle) {
+	bool     answer = false;
+	uint32_t next;
+	do {
+		if (Handle->Anim_Data == NULL) {
+			break;
+		}
+		if (Handle->Anim_Frame >= Handle->Anim_Num_Frame) {
+			Handle->Anim_Frame = 0;
+			Handle->Anim_Next  = WS28XX_ANIM_HEADER;
+		}
+		next = WS28XX_AnimDecode(Handle, Handle->Anim_Next, true);
+		if (next == 0) {
+			break;
+		}
+		Handle->Anim_Next = next;
+		Handle->Anim_Frame++;
+		answer = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Seek the animation
+ * @note   The frames from the last keyframe up to Frame are decoded, the next WS28XX_Animation_Next decodes
+ *         Frame. The frames before the keyframe are only walked over.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Frame: 0 to frames - 1
+ *
+ * @retval bool: true or false
+ */
+bool WS28XX_Animation_Seek(WS28XX_HandleTypeDef *Handle, uint16_t Frame) {
+	bool     answer    = false;
+	uint32_t offset    = WS28XX_ANIM_HEADER;
+	uint32_t key       = WS28XX_ANIM_HEADER;
+	uint16_t key_frame = 0;
+	do {
+		if ((Handle->Anim_Data == NULL) || (Frame >= Handle->Anim_Num_Frame)) {
+			break;
+		}
+		for (uint16_t f = 0; (f <= Frame) && (offset != 0); f++) {
+			if ((offset + 2) > Handle->Anim_Size) {
+				offset = 0;
+				break;
+			}
+			if (WS28XX_ANIM_U16(&Handle->Anim_Data[offset]) & WS28XX_ANIM_KEY) {
+				key       = offset;
+				key_frame = f;
+			}
+			if (f < Frame) {
+				offset = WS28XX_AnimDecode(Handle, offset, false);
+			}
+		}
+		if (offset == 0) {
+			break;
+		}
+		offset = key;
+		for (uint16_t f = key_frame; (f < Frame) && (offset != 0); f++) {
+			offset = WS28XX_AnimDecode(Handle, offset, true);
+		}
+		if (offset == 0) {
+			break;
+		}
+		Handle->Anim_Next  = offset;
+		Handle->Anim_Frame = Frame;
+		answer             = true;
+	} while (0);
+
+	return answer;
+}
+
+/***********************************************************************************************************/
+#endif
+
+#if (WS28XX_SCHEDULER == true)
+//@info Wire time of one frame and the latch after it, 0 before the Init functions
+uint64_t WS28XX_FrameNs(const WS28XX_HandleTypeDef *Handle) {
+	uint32_t pixel = Handle->Num_Pixel;
+#	if (WS28XX_MULTI_CHANNEL > 1)
+	if (Handle->Num_Strip > 1) {
+		pixel = Handle->Strip_Pixel;
+	}
+#	elif (WS28XX_GPIO_LANE > 0)
+	pixel = Handle->Strip_Pixel;
+#	endif
+	if (pixel == 0) {
+		return 0;
+	}
+	return (uint64_t)((pixel * WS28XX_PIXEL_SLOT) + 1 + Handle->Reset_Slot) * Handle->Slot_Ns;
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Highest frame rate of a WS28XX handle
+ * @note   One frame takes the pulses of every pixel of a strip plus the latch time of the chip. Strips of
+ *         WS28XX_Init_Multi and WS28XX_Init_Gpio are sent at the same time. The time the CPU needs to encode
+ *         is not included.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ *
+ * @retval uint16_t: Frames per second, 0 before the Init functions
+ */
+uint16_t WS28XX_MaxFrameRate(WS28XX_HandleTypeDef *Handle) {
+	uint64_t frame_ns = WS28XX_FrameNs(Handle);
+	if (frame_ns == 0) {
+		return 0;
 	}
-	Handle->Lock = 1;
+	return (1000000000ULL / frame_ns > 0xFFFF) ? 0xFFFF : (uint16_t)(1000000000ULL / frame_ns);
 }
 
 /***********************************************************************************************************/
 
-void WS28XX_UnLock(WS28XX_HandleTypeDef *Handle) {
-	Handle->Lock = 0;
-}
-
-/************************************************************************************************************
-**************    Public Functions
-************************************************************************************************************/
-
 /**
- * @brief  Initialize WS28XX handle
- * @note   Initialize WS28XX handle and set the Channel and number of Pixels
+ * @brief  Send frames at a fixed rate
+ * @note   WS28XX_Tick, called TickHz times a second, sends a frame every TickHz / Fps ticks, spread evenly when
+ *         they do not divide. The application only changes pixels and no longer calls WS28XX_Update, whatever
+ *         changed up to a frame is encoded at once and states in between are never queued. A frame with no
+ *         change is not sent. The rate is refused when it is above TickHz or when the wire cannot carry it,
+ *         see WS28XX_MaxFrameRate: the frames of the shortest spacing, TickHz / Fps rounded down ticks, must
+ *         not overlap.
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
- * @param  *HTim: Pointer to TIM_HandleTypeDef structure
- * @param  TimerBusFrequencyMHz: Frequency of timer bus frequency
- * @param  Channel: Selected PWM channel
- *         TIM_CHANNEL_1
- *         TIM_CHANNEL_2
- *         TIM_CHANNEL_3
- *         TIM_CHANNEL_4
- *         TIM_CHANNEL_5
- *         TIM_CHANNEL_6
- * @param  Pixel: Number of pixels
+ * @param  Fps: Frames per second, 0 stops the scheduler
+ * @param  TickHz: Rate of WS28XX_Tick calls, e.g. 1000 from the SysTick or an RTOS tick hook
  *
  * @retval bool: true or false
  */
-bool WS28XX_Init(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Channel, uint16_t Pixel) {
-	bool     answer = false;
-	uint32_t aar_value;
+bool WS28XX_SetFrameRate(WS28XX_HandleTypeDef *Handle, uint16_t Fps, uint32_t TickHz) {
+	bool answer = false;
 	do {
-		if (Handle == NULL || HTim == NULL) {
+		if ((Handle == NULL) || (TickHz == 0) || (Fps > TickHz)) {
 			break;
 		}
-		if (Pixel > WS28XX_PIXEL_MAX) {
+		//@important frames are whole ticks apart, TickHz / Fps rounded down must still cover one frame
+		if ((Fps > 0) && ((WS28XX_FrameNs(Handle) == 0) || ((((uint64_t)(TickHz / Fps)) * 1000000000ULL) / TickHz < WS28XX_FrameNs(Handle)))) {
 			break;
 		}
-		Handle->Channel   = Channel;
-		Handle->Num_Pixel = Pixel;
-		Handle->HTim      = HTim;
-		aar_value         = (TimerBusFrequencyMHz / (1.0f / (WS28XX_PULSE_LENGTH_NS / 1000.0f))) - 1;
-		__HAL_TIM_SET_AUTORELOAD(Handle->HTim, aar_value);
-		__HAL_TIM_SET_PRESCALER(Handle->HTim, 0);
-		Handle->Pulse0 = ((WS28XX_PULSE_0_NS / 1000.0f) * aar_value) / (WS28XX_PULSE_LENGTH_NS / 1000.0f);
-		Handle->Pulse1 = ((WS28XX_PULSE_1_NS / 1000.0f) * aar_value) / (WS28XX_PULSE_LENGTH_NS / 1000.0f);
-		memset(Handle->Pixel, 0, sizeof(Handle->Pixel));
-		memset(Handle->Buffer, 0, sizeof(Handle->Buffer));
-		HAL_TIM_PWM_Start_DMA(Handle->HTim, Handle->Channel, (const uint32_t *)Handle->Buffer, Pixel);
-		answer = true;
+		//@important stop WS28XX_Tick while the other fields change, it may run from an interrupt
+		Handle->Sched_Fps     = 0;
+		Handle->Sched_Tick_Hz = TickHz;
+		Handle->Sched_Phase   = 0;
+		Handle->Sched_Late    = 0;
+		Handle->Sched_Sending = 0;
+		Handle->Sched_Fps     = Fps;
+		answer                = true;
 	} while (0);
 
 	return answer;
@@ -131,410 +2985,308 @@ bool WS28XX_Init(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t
 /***********************************************************************************************************/
 
 /**
- * @brief  Set Pixel
- * @note   Fill the pixel By RGB Values
+ * @brief  Scheduler tick
+ * @note   Call it at the TickHz of WS28XX_SetFrameRate. When a frame is due and pixels changed, they are
+ *         encoded and sent. A due frame is put off to the next tick while the handle is locked, e.g. by an
+ *         WS28XX_Update of the application, so it can be called from an interrupt, and while the last frame
+ *         is still on the wire. The encoding runs in the
+ *         caller, keep the priority of the tick interrupt below the DMA interrupts.
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
- * @param  Pixel: Pixel Starts from 0 to Max - 1
- * @param  Red: Red Value, 0 to 255
- * @param  Green: Green Value, 0 to 255
- * @param  Blue: Blue Value, 0 to 255
  *
- * @retval bool: true or false
+ * @retval bool: true when a frame was started
  */
-bool WS28XX_SetPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue) {
-	bool answer = true;
-	do {
-		if (Pixel >= Handle->Num_Pixel) {
-			answer = false;
-			break;
-		}
-		uint8_t _brightness = MAX_OF_THREE(Red, Green, Blue);
-#if (WS28XX_GAMMA == false)
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = Red;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = Blue;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Red;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = Green;
-		Handle->Pixel[Pixel][1]         = Red;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	endif
-#else
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Red];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
+bool WS28XX_Tick(WS28XX_HandleTypeDef *Handle) {
+	if (Handle->Sched_Fps == 0) {
+		return false;
+	}
+	if (Handle->Sched_Phase < Handle->Sched_Tick_Hz) {
+		Handle->Sched_Phase += Handle->Sched_Fps;
+	}
+	if (Handle->Sched_Phase < Handle->Sched_Tick_Hz) {
+		return false;
+	}
+	if (Handle->Lock || Handle->Sched_Sending) {
+		Handle->Sched_Late++;
+		return false;
+	}
+	Handle->Sched_Phase -= Handle->Sched_Tick_Hz;
+	//@info latest frame wins, the setters since the last frame only grew the dirty span
+#	if (WS28XX_QUEUE > 0)
+	if ((Handle->Dirty_First > Handle->Dirty_Last) && (atomic_load_explicit(WS28XX_ATOMIC(Handle->Queue_Head), memory_order_relaxed) == Handle->Queue_Tail)) {
+		return false;
+	}
+#	else
+	if (Handle->Dirty_First > Handle->Dirty_Last) {
+		return false;
+	}
 #	endif
+	//@important set before the DMA starts, its callback may clear it before WS28XX_Update returns
+	Handle->Sched_Sending = 1;
+	if (WS28XX_Update(Handle) == false) {
+		Handle->Sched_Sending = 0;
+		return false;
+	}
+	return true;
+}
+
+/***********************************************************************************************************/
 #endif
-	} while (0);
-	return answer;
+
+#if (WS28XX_COLOR_LUT == true)
+/**
+ * @brief  Set gamma
+ * @note   The color LUT is rebuilt and all pixels are encoded again on the next WS28XX_Update
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Gamma: Gamma exponent, 1.0 is linear, 2.2 to 2.8 suits most LEDs
+ *
+ * @retval None
+ */
+void WS28XX_SetGamma(WS28XX_HandleTypeDef *Handle, float Gamma) {
+	Handle->Lut_Gamma   = Gamma;
+	Handle->Lut_Changed = true;
+	WS28XX_Refresh(Handle);
 }
 
 /***********************************************************************************************************/
 
 /**
- * @brief  Set Pixel
- * @note   Fill the pixel By RGB Values
+ * @brief  Set global brightness
+ * @note   Scales every pixel before gamma, so dimmed colors stay gamma correct
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
- * @param  Pixel: Pixel Starts from 0 to Max - 1
- * @param  Color: RGB565 Color Code
+ * @param  Brightness: 0 to 255
  *
- * @retval bool: true or false
+ * @retval None
  */
-bool WS28XX_SetPixel_RGB_565(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint16_t Color) {
-	bool    answer = true;
-	uint8_t Red, Green, Blue;
-	do {
-		if (Pixel >= Handle->Num_Pixel) {
-			answer = false;
-			break;
-		}
-		Red   = ((Color >> 8) & 0xF8);
-		Green = ((Color >> 3) & 0xFC);
-		Blue  = ((Color << 3) & 0xF8);
+void WS28XX_SetGlobalBrightness(WS28XX_HandleTypeDef *Handle, uint8_t Brightness) {
+	Handle->Lut_Brightness = Brightness;
+	Handle->Lut_Changed    = true;
+	WS28XX_Refresh(Handle);
+}
 
-		uint8_t _brightness = MAX_OF_THREE(Red, Green, Blue);
+/***********************************************************************************************************/
 
-#if (WS28XX_GAMMA == false)
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = Red;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = Blue;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Red;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = Green;
-		Handle->Pixel[Pixel][1]         = Red;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	endif
-#else
+/**
+ * @brief  Set color correction
+ * @note   Per channel white balance, each channel is scaled by Value / 255 before gamma
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  Red: Red scale, 0 to 255
+ * @param  Green: Green scale, 0 to 255
+ * @param  Blue: Blue scale, 0 to 255
+ *
+ * @retval None
+ */
+void WS28XX_SetColorCorrection(WS28XX_HandleTypeDef *Handle, uint8_t Red, uint8_t Green, uint8_t Blue) {
 #	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
+	Handle->Lut_Correction[0] = Red;
+	Handle->Lut_Correction[1] = Green;
+	Handle->Lut_Correction[2] = Blue;
 #	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Red];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
+	Handle->Lut_Correction[0] = Blue;
+	Handle->Lut_Correction[1] = Green;
+	Handle->Lut_Correction[2] = Red;
 #	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
+	Handle->Lut_Correction[0] = Green;
+	Handle->Lut_Correction[1] = Red;
+	Handle->Lut_Correction[2] = Blue;
 #	endif
-#endif
-	} while (0);
-	return answer;
+	Handle->Lut_Changed = true;
+	WS28XX_Refresh(Handle);
 }
 
 /***********************************************************************************************************/
+#endif
 
 /**
- * @brief  Set Pixel
- * @note   Fill the pixel By RGB Values
+ * @brief  DMA transfer complete callback
+ * @note   Call it from HAL_TIM_PWM_PulseFinishedCallback(). In streaming mode it refills the second half
+ *         of the buffer, in double buffer mode it sends the pending frame.
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
- * @param  Pixel: Pixel Starts from 0 to Max - 1
- * @param  Color: RGB888 Color Code
+ * @param  *HTim: Timer handle passed to the HAL callback
  *
- * @retval bool: true or false
+ * @retval None
  */
-bool WS28XX_SetPixel_RGB_888(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint32_t Color) {
-	bool    answer = true;
-	uint8_t Red, Green, Blue;
-	do {
-		if (Pixel >= Handle->Num_Pixel) {
-			answer = false;
-			break;
-		}
-		Red   = ((Color & 0xFF0000) >> 16);
-		Green = ((Color & 0x00FF00) >> 8);
-		Blue  = (Color & 0x0000FF);
-
-		uint8_t _brightness = MAX_OF_THREE(Red, Green, Blue);
-
-#if (WS28XX_GAMMA == false)
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = Red;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = Blue;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Red;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = Green;
-		Handle->Pixel[Pixel][1]         = Red;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	endif
+void WS28XX_PulseFinishedCallback(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim) {
+	if ((HTim != Handle->HTim) || (HTim->Channel != WS28XX_ACTIVE_CH(Handle->Channel))) {
+		return;
+	}
+#if (WS28XX_STREAM == true)
+	WS28XX_StreamNext(Handle, &Handle->Buffer[WS28XX_STREAM_HALF], true);
 #else
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Red];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = _brightness;
+#	if (WS28XX_DOUBLE_BUFFER == true)
+	//@info every frame ends with Reset_Slot low slots, the next one starts when the LEDs have latched
+	Handle->Busy = 0;
+#		if (WS28XX_STATS == true)
+	WS28XX_StatsDone(Handle);
+#		endif
+	if (Handle->Pending) {
+		WS28XX_SendDraw(Handle);
+	}
+#	elif (WS28XX_STATS == true)
+	WS28XX_StatsDone(Handle);
 #	endif
+	WS28XX_FrameDone(Handle);
 #endif
-	} while (0);
-	return answer;
 }
 
 /***********************************************************************************************************/
 
-bool WS28XX_SetPixel_RGBW(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t Brightness) {
-	bool answer = true;
-	do {
-		if (Pixel >= Handle->Num_Pixel) {
-			answer = false;
-			break;
-		}
+/**
+ * @brief  Frame done callback
+ * @note   Called from WS28XX_PulseFinishedCallback() when a frame has been sent. It is defined weak, override
+ *         it to pace rendering or to signal an RTOS event.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ *
+ * @retval None
+ */
+__weak void WS28XX_FrameDoneCallback(WS28XX_HandleTypeDef *Handle) {
+	(void)Handle;
+}
 
-#if (WS28XX_GAMMA == false)
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = Red;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = Blue;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Red;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = Green;
-		Handle->Pixel[Pixel][1]         = Red;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	endif
-#else
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Red];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	endif
+/***********************************************************************************************************/
+
+/**
+ * @brief  DMA half transfer callback
+ * @note   Call it from HAL_TIM_PWM_PulseFinishedHalfCpltCallback(). In streaming mode it refills the first
+ *         half of the buffer, otherwise it does nothing.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *HTim: Timer handle passed to the HAL callback
+ *
+ * @retval None
+ */
+void WS28XX_PulseFinishedHalfCpltCallback(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim) {
+	if ((HTim != Handle->HTim) || (HTim->Channel != WS28XX_ACTIVE_CH(Handle->Channel))) {
+		return;
+	}
+#if (WS28XX_STREAM == true)
+	WS28XX_StreamNext(Handle, &Handle->Buffer[0], false);
 #endif
-	} while (0);
-	return answer;
 }
 
+#if (WS28XX_SPI_SYMBOL > 0)
 /***********************************************************************************************************/
 
 /**
- * @brief  Set Pixel and Brightness
- * @note   Fill the pixel By RGB Values
+ * @brief  SPI transfer complete callback
+ * @note   Call it from HAL_SPI_TxCpltCallback() when the handle was initialized by WS28XX_Init_Spi().
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
- * @param  Pixel: Pixel Starts from 0 to Max - 1
- * @param  Color: RGB565 Color Code
- * @param  Brightness: Brightness level, 0 to 255
+ * @param  *HSpi: SPI handle passed to the HAL callback
  *
- * @retval bool: true or false
+ * @retval None
  */
-bool WS28XX_SetPixel_RGBW_565(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint16_t Color, uint8_t Brightness) {
-	bool    answer = true;
-	uint8_t Red, Green, Blue;
-	do {
-		if (Pixel >= Handle->Num_Pixel) {
-			answer = false;
-			break;
-		}
-		Red   = ((Color >> 8) & 0xF8);
-		Green = ((Color >> 3) & 0xFC);
-		Blue  = ((Color << 3) & 0xF8);
-
-#if (WS28XX_GAMMA == false)
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = Red;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = Blue;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Red;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = Green;
-		Handle->Pixel[Pixel][1]         = Red;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	endif
-#else
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Red];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
+void WS28XX_SpiTxCpltCallback(WS28XX_HandleTypeDef *Handle, SPI_HandleTypeDef *HSpi) {
+	if (HSpi != Handle->HSpi) {
+		return;
+	}
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsDone(Handle);
 #	endif
-#endif
-	} while (0);
-	return answer;
+	WS28XX_FrameDone(Handle);
 }
+#endif
 
+#if (WS28XX_MULTI_CHANNEL > 1)
 /***********************************************************************************************************/
 
 /**
- * @brief  Set Pixel and Brightness
- * @note   Fill the pixel By RGB Values
+ * @brief  DMA burst transfer complete callback
+ * @note   Call it from HAL_TIM_PeriodElapsedCallback() when the handle was initialized by WS28XX_Init_Multi().
+ *         It releases the DMA burst so the next frame can be started.
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
- * @param  Pixel: Pixel Starts from 0 to Max - 1
- * @param  Color: RGB888 Color Code
- * @param  Brightness: Brightness level, 0 to 255
+ * @param  *HTim: Timer handle passed to the HAL callback
  *
- * @retval bool: true or false
+ * @retval None
  */
-bool WS28XX_SetPixel_RGBW_888(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint32_t Color, uint8_t Brightness) {
-	bool    answer = true;
-	uint8_t Red, Green, Blue;
-	do {
-		if (Pixel >= Handle->Num_Pixel) {
-			answer = false;
-			break;
-		}
-		Red   = ((Color & 0xFF0000) >> 16);
-		Green = ((Color & 0x00FF00) >> 8);
-		Blue  = (Color & 0x0000FF);
-
-#if (WS28XX_GAMMA == false)
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = Red;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = Blue;
-		Handle->Pixel[Pixel][1]         = Green;
-		Handle->Pixel[Pixel][2]         = Red;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = Green;
-		Handle->Pixel[Pixel][1]         = Red;
-		Handle->Pixel[Pixel][2]         = Blue;
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	endif
-#else
-#	if WS28XX_ORDER == WS28XX_ORDER_RGB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_BGR
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Red];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
-#	elif WS28XX_ORDER == WS28XX_ORDER_GRB
-		Handle->Pixel[Pixel][0]         = WS28XX_GammaTable[Green];
-		Handle->Pixel[Pixel][1]         = WS28XX_GammaTable[Red];
-		Handle->Pixel[Pixel][2]         = WS28XX_GammaTable[Blue];
-		Handle->Pixel_Brightness[Pixel] = Brightness;
+void WS28XX_PeriodElapsedCallback(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim) {
+	if ((HTim != Handle->HTim) || (Handle->Num_Strip < 2)) {
+		return;
+	}
+	HAL_TIM_DMABurst_WriteStop(HTim, TIM_DMA_UPDATE);
+#	if (WS28XX_STATS == true)
+	WS28XX_StatsDone(Handle);
 #	endif
-#endif
-	} while (0);
-	return answer;
+	WS28XX_FrameDone(Handle);
 }
+#endif
 
+#if (WS28XX_STATS == true)
 /***********************************************************************************************************/
 
 /**
- * @brief  Send Buffer to LEDs
- * @note   This function use PWM+DMA for Sending data
+ * @brief  Reset the statistics of a WS28XX handle
+ * @note   Called by the Init functions. It also enables the DWT cycle counter, which a release build without a
+ *         debugger may leave stopped.
  *
  * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
  *
- * @retval bool: true or false
+ * @retval None
  */
-bool WS28XX_Update(WS28XX_HandleTypeDef *Handle) {
-	bool     answer = true;
-	uint32_t i      = 1;
-	WS28XX_Lock(Handle);
-	for (uint16_t pixel = 0; pixel < Handle->Num_Pixel; pixel++) {
-		if (Handle->Pixel_Brightness[pixel] == 0) {
-			for (uint8_t count = 0; count < 24; count++) {
-				Handle->Buffer[i] = Handle->Pulse0;
-				i++;
-			}
-		} else {
-			//@important RESOLUTION_OF_BRIGHTNESS for more resolution for BRIGHTNESS_SCALE, because BRIGHTNESS_SCALE when divided without RESOLUTION_OF_BRIGHTNESS will be a float value
-			uint16_t BRIGHTNESS_SCALE = RESOLUTION_OF_BRIGHTNESS * Handle->Pixel_Brightness[pixel] / MAX_OF_THREE(Handle->Pixel[pixel][0], Handle->Pixel[pixel][1], Handle->Pixel[pixel][2]);
-			for (int rgb = 0; rgb < 3; rgb++) {
-				uint8_t color = (Handle->Pixel[pixel][rgb] * BRIGHTNESS_SCALE) / RESOLUTION_OF_BRIGHTNESS;
-				for (int b = 7; b >= 0; b--) {
-					Handle->Buffer[i] = (color & (1 << b)) ? Handle->Pulse1 : Handle->Pulse0;
-					i++;
-				}
-			}
-		}
-	}
+void WS28XX_ResetStats(WS28XX_HandleTypeDef *Handle) {
+	uint32_t primask = __get_PRIMASK();
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	__disable_irq();
+	memset(&Handle->Stats_Encode, 0, sizeof(Handle->Stats_Encode));
+	memset(&Handle->Stats_Transfer, 0, sizeof(Handle->Stats_Transfer));
+	memset(&Handle->Stats_Lock, 0, sizeof(Handle->Stats_Lock));
+	Handle->Stats_Encode.Min   = 0xFFFFFFFF;
+	Handle->Stats_Transfer.Min = 0xFFFFFFFF;
+	Handle->Stats_Lock.Min     = 0xFFFFFFFF;
+	Handle->Stats_Sent         = 0;
+	Handle->Stats_Done         = 0;
+	Handle->Stats_Skipped      = 0;
+	Handle->Stats_Start        = WS28XX_CYCLE();
+	Handle->Stats_Fps_Start    = Handle->Stats_Start;
+	Handle->Stats_Fps_Frame    = 0;
+	Handle->Stats_Fps          = 0;
+	__set_PRIMASK(primask);
+}
 
-	if (HAL_TIM_PWM_Start_DMA(Handle->HTim, Handle->Channel, (const uint32_t *)Handle->Buffer, (Handle->Num_Pixel * 24) + 2) != HAL_OK) {
-		answer = false;
-	}
-	WS28XX_UnLock(Handle);
-	return answer;
+/***********************************************************************************************************/
+
+/**
+ * @brief  Read the statistics of a WS28XX handle
+ * @note   Times are in core clock cycles, divide them by Cycle_Hz for seconds. Fps_Centi is measured over
+ *         windows of one second and stays 0 until the first window has passed.
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  *Stats: Pointer to the WS28XX_StatsTypeDef structure to fill
+ *
+ * @retval None
+ */
+void WS28XX_GetStats(WS28XX_HandleTypeDef *Handle, WS28XX_StatsTypeDef *Stats) {
+	uint32_t           primask = __get_PRIMASK();
+	WS28XX_StatTypeDef encode, transfer, lock;
+	//@important the DMA callbacks update the counters, copy them in one go
+	__disable_irq();
+	encode               = Handle->Stats_Encode;
+	transfer             = Handle->Stats_Transfer;
+	lock                 = Handle->Stats_Lock;
+	Stats->Frame_Sent    = Handle->Stats_Sent;
+	Stats->Frame_Done    = Handle->Stats_Done;
+	Stats->Frame_Skipped = Handle->Stats_Skipped;
+	Stats->Fps_Centi     = Handle->Stats_Fps;
+	__set_PRIMASK(primask);
+	Stats->Encode_Min      = (encode.Count == 0) ? 0 : encode.Min;
+	Stats->Encode_Avg      = (encode.Count == 0) ? 0 : (uint32_t)(encode.Sum / encode.Count);
+	Stats->Encode_Max      = encode.Max;
+	Stats->Transfer_Min    = (transfer.Count == 0) ? 0 : transfer.Min;
+	Stats->Transfer_Avg    = (transfer.Count == 0) ? 0 : (uint32_t)(transfer.Sum / transfer.Count);
+	Stats->Transfer_Max    = transfer.Max;
+	Stats->Lock_Wait_Count = lock.Count;
+	Stats->Lock_Wait_Avg   = (lock.Count == 0) ? 0 : (uint32_t)(lock.Sum / lock.Count);
+	Stats->Lock_Wait_Max   = lock.Max;
+	Stats->Cycle_Hz        = SystemCoreClock;
 }
+#endif
 
 /***********************************************************************************************************/
 
@@ -550,11 +3302,24 @@ bool WS28XX_Update(WS28XX_HandleTypeDef *Handle) {
  * @retval None.
  */
 void WS28XX_SetAllPixel_Brightness(WS28XX_HandleTypeDef *Handle, uint8_t Brightness) {
+#if (WS28XX_FRAMEBUFFER == true)
+	//@info the frame holds no brightness, every color is scaled by Brightness / 255 while encoding
+	Handle->Frame_Scale = ((Brightness << 16) + 127) / 255;
+#elif (WS28XX_PALETTE > 0)
+	//@info the pixels hold no brightness, it is set on every entry as the setters do on pixels
+	for (uint16_t entry = 0; entry < WS28XX_PALETTE; entry++) {
+		Handle->Palette[entry].Brightness = Brightness;
+	}
+	WS28XX_BuildPalette(Handle, 0, WS28XX_PALETTE);
+#else
 	for (uint16_t pixel = 0; pixel < Handle->Num_Pixel; pixel++) {
-		Handle->Pixel_Brightness[pixel] = Brightness;
+		Handle->Pixel[pixel].Brightness = Brightness;
 	}
+#endif
+	WS28XX_Refresh(Handle);
 }
 
+#if (WS28XX_FRAMEBUFFER == false) && (WS28XX_PALETTE == 0)
 /***********************************************************************************************************/
 
 /**
@@ -572,6 +3337,40 @@ void WS28XX_SetAllPixel_Brightness(WS28XX_HandleTypeDef *Handle, uint8_t Brightn
  */
 
 void WS28XX_SetOnePixel_Brightness(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Brightness) {
-	Handle->Pixel_Brightness[Pixel] = Brightness;
+	if (Pixel >= Handle->Num_Pixel) {
+		return;
+	}
+	Handle->Pixel[Pixel].Brightness = Brightness;
+	WS28XX_MarkDirty(Handle, Pixel, Pixel);
+}
+
+/***********************************************************************************************************/
+
+/**
+ * @brief  Set the brightness of a range of pixels
+ * @note   Like WS28XX_SetOnePixel_Brightness on Count pixels from First, only that range is encoded again
+ *
+ * @param  *Handle: Pointer to WS28XX_HandleTypeDef structure
+ * @param  First: First pixel, 0 to Max - 1
+ * @param  Count: Number of pixels
+ * @param  Brightness: Brightness level, 0 to 255
+ *
+ * @retval bool: true or false, nothing is written when the range does not fit the strip
+ */
+bool WS28XX_SetRangePixel_Brightness(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Brightness) {
+	bool answer = false;
+	do {
+		if ((Count == 0) || (((uint32_t)First + Count) > Handle->Num_Pixel)) {
+			break;
+		}
+		for (WS28XX_PixelTypeDef *px = &Handle->Pixel[First], *end = px + Count; px < end; px++) {
+			px->Brightness = Brightness;
+		}
+		WS28XX_MarkDirty(Handle, First, First + Count - 1);
+		answer = true;
+	} while (0);
+
+	return answer;
 }
+#endif
 /***********************************************************************************************************/
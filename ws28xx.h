@@ -30,6 +30,9 @@ extern "C" {
 #include <stdbool.h>
 #include "tim.h"
 #include "ws2812b_conf.h"
+#if (WS28XX_SPI_SYMBOL > 0)
+#	include "spi.h"
+#endif
 
 /************************************************************************************************************
 **************    Public Definitions
@@ -115,41 +118,390 @@ extern "C" {
 
 #define RESOLUTION_OF_BRIGHTNESS 100
 #define MAX_OF_THREE(a, b, c)    ((a) > (b) ? ((a) > (c) ? (a) : (c)) : ((b) > (c) ? (b) : (c)))
+#define WS28XX_PIXEL_SLOT        (WS28XX_COLOR_CHANNEL * 8) //@info Pulses of one pixel, 8 per color byte
+#define WS28XX_RESET_NS          300000                     //@info Longest latch time of the supported chips (WS2812B/WS2815: 280us)
+#define WS28XX_SLOT_NS_MIN       (((WS28XX_PULSE_LENGTH_NS) < 1100) ? (WS28XX_PULSE_LENGTH_NS) : 1100) //@info Shortest bit time of the chips, WS2815
+
+#if (WS28XX_GPIO_LANE == 0) && (WS28XX_SPI_SYMBOL == 0)
+//@info Low slots closing a PWM frame, the line stays low for WS28XX_RESET_NS at the shortest bit time so the chips latch before the next one
+#	define WS28XX_LATCH_PAD ((WS28XX_RESET_NS + WS28XX_SLOT_NS_MIN - 1) / WS28XX_SLOT_NS_MIN)
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0)
+//@info Zero bytes closing a SPI frame, MOSI stays low for WS28XX_RESET_NS so the chips latch before the next one
+#	define WS28XX_SPI_LATCH (((WS28XX_RESET_NS * WS28XX_SPI_SYMBOL) + (8 * WS28XX_PULSE_LENGTH_NS) - 1) / (8 * WS28XX_PULSE_LENGTH_NS))
+#endif
+
+//@info Slots of one pulse buffer for Pixel pixels
+#if (WS28XX_STREAM == true)
+#	define WS28XX_BUFFER_SLOT(Pixel) (WS28XX_STREAM_PIXEL * WS28XX_PIXEL_SLOT * 2)
+#elif (WS28XX_SPI_SYMBOL > 0)
+#	define WS28XX_BUFFER_SLOT(Pixel) (((Pixel) * WS28XX_COLOR_CHANNEL * WS28XX_SPI_SYMBOL) + 1 + WS28XX_SPI_LATCH)
+#elif (WS28XX_GPIO_LANE > 0)
+#	define WS28XX_BUFFER_SLOT(Pixel) ((((Pixel) + WS28XX_GPIO_LANE - 1) / WS28XX_GPIO_LANE) * WS28XX_PIXEL_SLOT)
+#else
+#	define WS28XX_BUFFER_SLOT(Pixel) (((Pixel) * WS28XX_PIXEL_SLOT) + ((1 + WS28XX_LATCH_PAD) * WS28XX_MULTI_CHANNEL))
+#endif
+
+//@info Length of the WS28XX_SlotTypeDef array WS28XX_SetBuffer needs for Pixel pixels, both buffers with WS28XX_DOUBLE_BUFFER
+#define WS28XX_PULSE_BUFFER(Pixel) (WS28XX_BUFFER_SLOT(Pixel) * ((WS28XX_DOUBLE_BUFFER == true) ? 2 : 1))
+
+#if (WS28XX_ANIMATION == true)
+//@info Animation of WS28XX_SetAnimation, every number is a little endian uint16_t
+//        Header: WS28XX_ANIM_MAGIC, pixels, frames, frames per second
+//        Frame:  span count, with WS28XX_ANIM_KEY on a keyframe, then the spans
+//        Span:   first pixel, pixel count, then runs until the count is covered
+//        Run:    WS28XX_ANIM_RUN | (n - 1) and one color for n equal pixels, or n - 1 and n colors. 1 <= n <= 128
+//      Colors are red, green and blue. Pixels outside the spans keep the previous frame, a keyframe covers all
+#	define WS28XX_ANIM_MAGIC          "WSA1"
+#	define WS28XX_ANIM_HEADER         10
+#	define WS28XX_ANIM_KEY            0x8000
+#	define WS28XX_ANIM_RUN            0x80
+#endif
 
 /************************************************************************************************************
 **************    Public struct/enum
 ************************************************************************************************************/
 
+typedef enum {
+	WS28XX_CHIP_CONF = 0, //@info WS28XX_PULSE_LENGTH_NS, WS28XX_PULSE_0_NS and WS28XX_PULSE_1_NS of ws2812b_conf.h
+	WS28XX_CHIP_WS2811,   //@info 400 kHz
+	WS28XX_CHIP_WS2812,
+	WS28XX_CHIP_WS2812B,
+	WS28XX_CHIP_WS2815,
+	WS28XX_CHIP_SK6812,
+} WS28XX_ChipTypeDef;
+
+typedef enum {
+	WS28XX_FORMAT_888 = 0, //@info 3 bytes per pixel
+	WS28XX_FORMAT_8888,    //@info 4 bytes per pixel, white or unused last
+	WS28XX_FORMAT_565,     //@info uint16_t RGB565
+} WS28XX_FormatTypeDef;
+
+#if (WS28XX_STATS == true)
 typedef struct {
-	TIM_HandleTypeDef *HTim;
-	uint16_t           Pulse0;
-	uint16_t           Pulse1;
-	uint16_t           Num_Pixel;
-	uint16_t           Pixel[WS28XX_PIXEL_MAX][3];
-	uint16_t           Buffer[(WS28XX_PIXEL_MAX * 24) + 2];
-	uint8_t            Channel;
-	uint8_t            Lock;
-	uint8_t            Pixel_Brightness[(WS28XX_PIXEL_MAX)];
+	uint32_t Min; //@info Cycles of the shortest sample, 0xFFFFFFFF before the first one
+	uint32_t Max;
+	uint32_t Count;
+	uint64_t Sum;
+} WS28XX_StatTypeDef;
+
+typedef struct {
+	uint32_t Encode_Min;      //@info Cycles of WS28XX_Update from taking the lock to starting the DMA
+	uint32_t Encode_Avg;
+	uint32_t Encode_Max;
+	uint32_t Transfer_Min;    //@info Cycles from the DMA start to the end of the frame
+	uint32_t Transfer_Avg;
+	uint32_t Transfer_Max;
+	uint32_t Lock_Wait_Count; //@info WS28XX_Lock calls that found the lock taken
+	uint32_t Lock_Wait_Avg;   //@info Cycles those calls waited
+	uint32_t Lock_Wait_Max;
+	uint32_t Frame_Sent;      //@info Frames handed to the DMA
+	uint32_t Frame_Done;      //@info Frames that reached WS28XX_FrameDoneCallback
+	uint32_t Frame_Skipped;   //@info Updates that sent nothing: clean, replaced while queued or refused by the HAL
+	uint32_t Fps_Centi;       //@info Frames done per 100 s over the last full second
+	uint32_t Cycle_Hz;        //@info Cycles per second, SystemCoreClock
+} WS28XX_StatsTypeDef;
+#endif
+
+#if (WS28XX_QUEUE > 0)
+typedef enum {
+	WS28XX_COMMAND_PIXEL = 0,   //@info WS28XX_SetPixel_RGB of First
+	WS28XX_COMMAND_FILL,        //@info WS28XX_FillPixel_RGB of Count pixels from First
+	WS28XX_COMMAND_BRIGHTNESS,  //@info WS28XX_SetRangePixel_Brightness of Count pixels from First, Value[0]
+} WS28XX_CommandIdTypeDef;
+
+typedef struct {
+	uint32_t Sequence; //@info Position the cell is free for, that position + 1 once the command is written
+	uint8_t  Id;       //@info WS28XX_CommandIdTypeDef
+	uint8_t  Value[3]; //@info Red, green and blue, or the brightness
+	uint16_t First;
+	uint16_t Count;
+} WS28XX_CommandTypeDef;
+#endif
+
+#if (WS28XX_MATRIX == true)
+typedef enum {
+	WS28XX_LAYOUT_ROW = 0,           //@info Rows from the top, each one from the left
+	WS28XX_LAYOUT_SERPENTINE,        //@info Rows from the top, every second one from the right
+	WS28XX_LAYOUT_COLUMN,            //@info Columns from the left, each one from the top
+	WS28XX_LAYOUT_COLUMN_SERPENTINE, //@info Columns from the left, every second one from the bottom
+} WS28XX_LayoutTypeDef;
+
+typedef enum {
+	WS28XX_ROTATE_0 = 0,
+	WS28XX_ROTATE_90,    //@info Clockwise, the top left of the image is at the top right of the matrix
+	WS28XX_ROTATE_180,
+	WS28XX_ROTATE_270,
+} WS28XX_RotateTypeDef;
+
+typedef struct {
+	uint16_t Width;       //@info Pixels of the whole matrix as it is wired, before the rotation
+	uint16_t Height;
+	uint16_t Tile_Width;  //@info Pixels of one tile, Width and Height for a single panel. Must divide Width and Height
+	uint16_t Tile_Height;
+	uint8_t  Layout;      //@info WS28XX_LayoutTypeDef of the pixels in every tile, the strip enters each tile at its top left
+	uint8_t  Tile_Layout; //@info WS28XX_LayoutTypeDef of the tiles along the strip
+	uint8_t  Rotate;      //@info WS28XX_RotateTypeDef of the image on the matrix
+} WS28XX_MatrixTypeDef;
+#endif
+
+#if (WS28XX_SPI_SYMBOL > 0)
+typedef uint8_t  WS28XX_SlotTypeDef; //@info WS28XX_SPI_SYMBOL bit symbols, MSB first
+#elif (WS28XX_GPIO_LANE > 0)
+typedef uint32_t WS28XX_SlotTypeDef; //@info One BSRR word per bit of all lanes, resets the lanes sending a 0
+#elif (WS28XX_BYTE_PULSE == true)
+typedef uint8_t  WS28XX_SlotTypeDef; //@info One compare value per bit, widened to the compare register by the DMA
+#else
+typedef uint16_t WS28XX_SlotTypeDef; //@info One compare value per bit
+#endif
+
+typedef struct {
+	uint8_t Color[WS28XX_COLOR_CHANNEL]; //@info Channels in WS28XX_ORDER, the order they are sent, white last on RGBW chips
+	uint8_t Brightness;                  //@info Value the brightest channel is scaled to in WS28XX_Update
+} WS28XX_PixelTypeDef;
+
+#if (WS28XX_PALETTE > 0)
+typedef uint8_t             WS28XX_PixelStoreTypeDef; //@info Entry of the palette the pixel shows
+#else
+typedef WS28XX_PixelTypeDef WS28XX_PixelStoreTypeDef;
+#endif
+
+typedef struct __WS28XX_HandleTypeDef {
+	TIM_HandleTypeDef  *HTim;
+	uint16_t            Pulse0;
+	uint16_t            Pulse1;
+	uint16_t            Num_Pixel;
+	uint16_t            Reset_Slot; //@info Low slots the chip needs to latch a frame, from its timing profile
+#if (WS28XX_FRAMEBUFFER == true)
+	const void         *Frame;        //@info Pixels of WS28XX_SetFrameBuffer, owned by the application
+	uint8_t             Frame_Format; //@info WS28XX_FormatTypeDef of Frame
+	uint8_t             Frame_Map[3]; //@info Byte of a Frame pixel sent as each of the first three channels
+	uint32_t            Frame_Scale;  //@info Brightness of WS28XX_SetAllPixel_Brightness in 16.16 fixed point
+#endif
+#if (WS28XX_PALETTE > 0)
+	WS28XX_PixelTypeDef Palette[WS28XX_PALETTE];                           //@info Colors of the entries as the setters store them
+	uint8_t             Palette_Byte[WS28XX_PALETTE][WS28XX_COLOR_CHANNEL]; //@info Entries as they are sent, brightness, white extraction and the color LUT applied
+#endif
+#if (WS28XX_EXTERNAL_BUFFER == true)
+	uint16_t            Buffer_Pixel; //@info Pixels the buffers of WS28XX_SetBuffer hold
+#	if (WS28XX_FRAMEBUFFER == false)
+	WS28XX_PixelStoreTypeDef *Pixel;
+#	endif
+	WS28XX_SlotTypeDef *Buffer;
+#else
+#	if (WS28XX_FRAMEBUFFER == false)
+	WS28XX_PixelStoreTypeDef Pixel[WS28XX_PIXEL_MAX];
+#	endif
+	WS28XX_SlotTypeDef  Buffer[WS28XX_BUFFER_SLOT(WS28XX_PIXEL_MAX)]; //@info With WS28XX_STREAM two halves of WS28XX_STREAM_PIXEL pixels, refilled from the DMA callbacks
+#endif
+#if (WS28XX_DOUBLE_BUFFER == true)
+#	if (WS28XX_EXTERNAL_BUFFER == true)
+	WS28XX_SlotTypeDef *Buffer_Back;
+#	else
+	WS28XX_SlotTypeDef  Buffer_Back[WS28XX_BUFFER_SLOT(WS28XX_PIXEL_MAX)];
+#	endif
+	WS28XX_SlotTypeDef *Draw;       //@info Buffer the next frame is encoded into, the DMA reads the other one
+	volatile uint8_t    Busy;       //@info DMA is sending a frame
+	volatile uint8_t    Pending;    //@info Draw holds an encoded frame waiting for the DMA
+	uint16_t            Prev_First; //@info Dirty span of the frame encoded into the other buffer, Draw misses it
+	uint16_t            Prev_Last;
+#endif
+	uint8_t             Channel;
+	uint8_t             Lock;
+	uint16_t            Dirty_First; //@info First pixel changed since the last WS28XX_Update, 0xFFFF when clean
+	uint16_t            Dirty_Last;  //@info Last pixel changed since the last WS28XX_Update
+#if (WS28XX_MULTI_CHANNEL > 1)
+	uint8_t             Num_Strip;   //@info Channels driven by one DMA burst, 1 for a single channel handle
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1) || (WS28XX_GPIO_LANE > 0)
+	uint16_t            Strip_Pixel; //@info Pixels of each strip, strip n holds pixels n * Strip_Pixel and up
+#endif
+#if (WS28XX_SPI_SYMBOL > 0)
+	SPI_HandleTypeDef  *HSpi;
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+	GPIO_TypeDef       *GPIOx;      //@info Port of the lanes, strip n is on pin n
+	uint32_t            Gpio_Set;   //@info BSRR word of the update DMA, sets every lane
+	uint32_t            Gpio_Reset; //@info BSRR word of the channel 2 DMA, resets every lane
+	volatile uint8_t    Gpio_Busy;  //@info 1 while a frame is sent, 2 while the lanes stay low for Reset_Slot periods after it
+	struct __WS28XX_HandleTypeDef *Gpio_Next; //@info Next handle of the GPIO backend
+#endif
+#if (WS28XX_ENCODER_TABLE == true)
+	uint32_t            Pulse_Table[256][(WS28XX_BYTE_PULSE == true) ? 2 : 4]; //@info 8 pulses (Pulse0/Pulse1) of each byte value, MSB first, built in WS28XX_Init
+#endif
+#if (WS28XX_COLOR_LUT == true)
+	uint8_t             Lut[WS28XX_COLOR_CHANNEL][256];       //@info Gamma, global brightness and color correction of each channel in WS28XX_ORDER
+	float               Lut_Gamma;
+	uint8_t             Lut_Brightness;
+	uint8_t             Lut_Correction[WS28XX_COLOR_CHANNEL]; //@info In WS28XX_ORDER, white stays 255
+	bool                Lut_Changed;                          //@info Lut is rebuilt by the next WS28XX_Update
+#endif
+#if (WS28XX_STREAM == true)
+	uint16_t            Stream_Chunk;    //@info Next chunk of WS28XX_STREAM_PIXEL pixels to encode
+	uint16_t            Stream_Last;     //@info Last chunk of the frame, including the reset chunks
+	uint32_t            Stream_Underrun; //@info Number of chunks encoded after the DMA had already reached them
+#endif
+#if (WS28XX_QUEUE > 0)
+	WS28XX_CommandTypeDef Queue[WS28XX_QUEUE]; //@info Commands of WS28XX_Post_*, applied by the next WS28XX_Update
+	uint32_t            Queue_Head; //@info Next position a producer claims, Sequence and Queue_Full too are only accessed atomically by ws28xx.c
+	uint32_t            Queue_Tail; //@info Next position to apply, only moved under the lock
+	uint32_t            Queue_Full; //@info Posts refused because every cell was taken
+#endif
+#if (WS28XX_MATRIX == true)
+	uint16_t           *Matrix_Map;    //@info Strip index of every x, y of the matrix functions, row by row, built by WS28XX_SetMatrix
+	uint16_t            Matrix_Width;  //@info Columns and rows the x, y refer to, after the rotation
+	uint16_t            Matrix_Height;
+#endif
+#if (WS28XX_INGEST == true)
+	uint8_t             Ingest_State; //@info Part of the Adalight frame the next byte belongs to
+	uint8_t             Ingest_Byte;  //@info Bytes of the current pixel received, the first two wait in Ingest_Rgb
+	uint8_t             Ingest_Rgb[2];
+	uint16_t            Ingest_Last;  //@info Last pixel of the frame, the LED count of the header - 1
+	uint16_t            Ingest_Tail;  //@info Next byte of the ring WS28XX_Ingest_Ring reads
+	uint32_t            Ingest_Pixel; //@info Next pixel of the payload
+	uint32_t            Ingest_Frame; //@info Frames received
+	uint32_t            Ingest_Error; //@info Headers dropped for a wrong checksum
+#endif
+#if (WS28XX_ANIMATION == true)
+	const uint8_t      *Anim_Data;      //@info Animation of WS28XX_SetAnimation, e.g. in memory mapped flash
+	uint32_t            Anim_Size;
+	uint32_t            Anim_Next;      //@info Offset of the next frame in Anim_Data
+	uint16_t            Anim_Frame;     //@info Index of the next frame
+	uint16_t            Anim_Num_Frame;
+	uint16_t            Anim_Fps;       //@info Frame rate of the header, e.g. for WS28XX_SetFrameRate
+#endif
+#if (WS28XX_SCHEDULER == true)
+	uint16_t            Slot_Ns;        //@info Bit time of the timing profile
+	uint16_t            Sched_Fps;      //@info Frame rate of WS28XX_SetFrameRate, 0 when stopped
+	uint32_t            Sched_Tick_Hz;  //@info Rate WS28XX_Tick is called at
+	uint32_t            Sched_Phase;    //@info Grows by Sched_Fps every tick, a frame is due when it reaches Sched_Tick_Hz
+	uint32_t            Sched_Late;     //@info Due frames put off by a tick because the handle was locked or the last frame still on the wire
+	volatile uint8_t    Sched_Sending;  //@info A frame of WS28XX_Tick or its latch time is on the wire, cleared by the DMA callback
+#endif
+#if (WS28XX_STATS == true)
+	WS28XX_StatTypeDef  Stats_Encode;    //@info Read them with WS28XX_GetStats
+	WS28XX_StatTypeDef  Stats_Transfer;
+	WS28XX_StatTypeDef  Stats_Lock;
+	uint32_t            Stats_Sent;
+	uint32_t            Stats_Done;
+	uint32_t            Stats_Skipped;
+	uint32_t            Stats_Start;     //@info Cycle counter when the DMA of the current frame was started
+	uint32_t            Stats_Fps_Start; //@info Cycle counter at the start of the one second FPS window
+	uint32_t            Stats_Fps_Frame; //@info Frames done in the FPS window
+	uint32_t            Stats_Fps;       //@info Frames done per 100 s of the last full window
+#endif
 } WS28XX_HandleTypeDef;
 
 /************************************************************************************************************
 **************    Public Functions
 ************************************************************************************************************/
 
+#if (WS28XX_EXTERNAL_BUFFER == true)
+bool WS28XX_SetBuffer(WS28XX_HandleTypeDef *Handle, WS28XX_PixelStoreTypeDef *PixelBuffer, WS28XX_SlotTypeDef *PulseBuffer, uint16_t Pixel); //@info Call before the Init functions
+#endif
 bool WS28XX_Init(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Channel, uint16_t Pixel);
+bool WS28XX_Init_Chip(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Channel, uint16_t Pixel, WS28XX_ChipTypeDef Chip);
+#if (WS28XX_SPI_SYMBOL > 0)
+bool WS28XX_Init_Spi(WS28XX_HandleTypeDef *Handle, SPI_HandleTypeDef *HSpi, uint16_t Pixel);
+#endif
+#if (WS28XX_GPIO_LANE > 0)
+bool WS28XX_Init_Gpio(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, GPIO_TypeDef *GPIOx, uint16_t Pixel);
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+bool WS28XX_Init_Multi(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim, uint16_t TimerBusFrequencyMHz, uint8_t Strip, uint16_t Pixel);
+#endif
+#if (WS28XX_FRAMEBUFFER == true)
+bool WS28XX_SetFrameBuffer(WS28XX_HandleTypeDef *Handle, const void *Frame, WS28XX_FormatTypeDef Format, uint8_t Order); //@info Call after the Init functions
+#elif (WS28XX_PALETTE > 0)
+bool WS28XX_SetPixel_Index(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Index);
+bool WS28XX_FillPixel_Index(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Index);        //@info Count pixels from First
+bool WS28XX_CopyPixel_Index(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint8_t *Index); //@info One entry per pixel
+
+bool WS28XX_SetPalette_RGB(WS28XX_HandleTypeDef *Handle, uint8_t Index, uint8_t Red, uint8_t Green, uint8_t Blue);
+bool WS28XX_CopyPalette_RGB_888(WS28XX_HandleTypeDef *Handle, uint8_t First, uint16_t Count, const uint8_t *Rgb);                                  //@info 3 bytes per entry, red first
+bool WS28XX_RotatePalette(WS28XX_HandleTypeDef *Handle, uint8_t First, uint16_t Count, uint16_t Shift);                                            //@info Entry n takes the color of n - Shift
+bool WS28XX_BlendPalette(WS28XX_HandleTypeDef *Handle, uint8_t First, uint16_t Count, const uint8_t *From, const uint8_t *To, uint8_t Amount); //@info 0 is From, 255 is To
+#else
 bool WS28XX_SetPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue);
 bool WS28XX_SetPixel_RGB_565(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint16_t Color);
 bool WS28XX_SetPixel_RGB_888(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint32_t Color);
+#	if (WS28XX_COLOR_CHANNEL == 4)
+bool WS28XX_SetPixel_RGB_White(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t White); //@info RGBW chips, White is the fourth LED
+#	endif
 
 bool WS28XX_SetPixel_RGBW(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t Brightness);
 
 bool WS28XX_SetPixel_RGBW_565(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint16_t Color, uint8_t Brightness);
 bool WS28XX_SetPixel_RGBW_888(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint32_t Color, uint8_t Brightness);
 
+bool WS28XX_FillPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Red, uint8_t Green, uint8_t Blue); //@info Count pixels from First
+bool WS28XX_CopyPixel_RGB_888(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint8_t *Rgb);                 //@info 3 bytes per pixel, red first
+bool WS28XX_CopyPixel_RGB_565(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint16_t *Color);
+bool WS28XX_CopyPixel_Raw(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, const uint8_t *Color);                   //@info WS28XX_COLOR_CHANNEL bytes per pixel in WS28XX_ORDER
+#endif
+
 void WS28XX_SetAllPixel_Brightness(WS28XX_HandleTypeDef *Handle, uint8_t Brightness);                 //@info Set all pixel brightness
+#if (WS28XX_FRAMEBUFFER == false) && (WS28XX_PALETTE == 0)
 void WS28XX_SetOnePixel_Brightness(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Brightness); //@info Set only one pixel brightness
+bool WS28XX_SetRangePixel_Brightness(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Brightness); //@info Set the brightness of Count pixels from First
+#endif
 
 bool WS28XX_Update(WS28XX_HandleTypeDef *Handle);
+void WS28XX_Refresh(WS28XX_HandleTypeDef *Handle); //@info Encode and send all pixels on the next WS28XX_Update
+bool WS28XX_RefreshRange(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count); //@info Encode and send Count pixels from First on the next WS28XX_Update
+
+#if (WS28XX_QUEUE > 0)
+bool WS28XX_Post_Pixel(WS28XX_HandleTypeDef *Handle, uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue);                   //@info Never blocks, safe from interrupts and other tasks
+bool WS28XX_Post_Fill(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Red, uint8_t Green, uint8_t Blue);
+bool WS28XX_Post_Brightness(WS28XX_HandleTypeDef *Handle, uint16_t First, uint16_t Count, uint8_t Brightness);
+#endif
+
+#if (WS28XX_MATRIX == true)
+bool WS28XX_SetMatrix(WS28XX_HandleTypeDef *Handle, uint16_t *Map, const WS28XX_MatrixTypeDef *Matrix); //@info Call after the Init functions, Map holds Width * Height entries
+bool WS28XX_Matrix_SetPixel_RGB(WS28XX_HandleTypeDef *Handle, uint16_t X, uint16_t Y, uint8_t Red, uint8_t Green, uint8_t Blue);
+bool WS28XX_Matrix_FillRect_RGB(WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, uint8_t Red, uint8_t Green, uint8_t Blue);
+bool WS28XX_Matrix_FillSpan_RGB(WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Length, uint8_t Red, uint8_t Green, uint8_t Blue);
+bool WS28XX_Matrix_Blit_RGB_888(WS28XX_HandleTypeDef *Handle, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const uint8_t *Rgb);
+#endif
+
+#if (WS28XX_INGEST == true)
+uint16_t WS28XX_Ingest(WS28XX_HandleTypeDef *Handle, const uint8_t *Data, uint32_t Length);                   //@info Adalight frames, returns the frames completed
+uint16_t WS28XX_Ingest_Ring(WS28XX_HandleTypeDef *Handle, const uint8_t *Ring, uint16_t Size, uint16_t Head); //@info Reads a circular DMA buffer up to Head
+#endif
+
+#if (WS28XX_ANIMATION == true)
+bool WS28XX_SetAnimation(WS28XX_HandleTypeDef *Handle, const uint8_t *Data, uint32_t Size); //@info Call after the Init functions
+bool WS28XX_Animation_Next(WS28XX_HandleTypeDef *Handle);                                  //@info Decode the next frame, the first one after the last
+bool WS28XX_Animation_Seek(WS28XX_HandleTypeDef *Handle, uint16_t Frame);                  //@info Frame is decoded by the next WS28XX_Animation_Next
+#endif
+
+#if (WS28XX_SCHEDULER == true)
+uint16_t WS28XX_MaxFrameRate(WS28XX_HandleTypeDef *Handle);                          //@info Frames per second the wire can carry, call after the Init functions
+bool     WS28XX_SetFrameRate(WS28XX_HandleTypeDef *Handle, uint16_t Fps, uint32_t TickHz); //@info 0 stops the scheduler
+bool     WS28XX_Tick(WS28XX_HandleTypeDef *Handle);                                  //@info Call TickHz times a second, from a timer interrupt or an RTOS timer
+#endif
+
+#if (WS28XX_COLOR_LUT == true)
+void WS28XX_SetGamma(WS28XX_HandleTypeDef *Handle, float Gamma);                                          //@info 1.0 is linear
+void WS28XX_SetGlobalBrightness(WS28XX_HandleTypeDef *Handle, uint8_t Brightness);                        //@info 255 is full brightness
+void WS28XX_SetColorCorrection(WS28XX_HandleTypeDef *Handle, uint8_t Red, uint8_t Green, uint8_t Blue); //@info 255 keeps the channel as is
+#endif
+
+#if (WS28XX_STATS == true)
+void WS28XX_ResetStats(WS28XX_HandleTypeDef *Handle);                               //@info Also starts the DWT cycle counter
+void WS28XX_GetStats(WS28XX_HandleTypeDef *Handle, WS28XX_StatsTypeDef *Stats); //@info Times are in cycles of Cycle_Hz
+#endif
+
+void WS28XX_PulseFinishedCallback(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim);         //@info Call from HAL_TIM_PWM_PulseFinishedCallback
+void WS28XX_FrameDoneCallback(WS28XX_HandleTypeDef *Handle);                                     //@info Weak, called from the DMA callback when a frame is sent
+void WS28XX_PulseFinishedHalfCpltCallback(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim); //@info Call from HAL_TIM_PWM_PulseFinishedHalfCpltCallback
+#if (WS28XX_SPI_SYMBOL > 0)
+void WS28XX_SpiTxCpltCallback(WS28XX_HandleTypeDef *Handle, SPI_HandleTypeDef *HSpi); //@info Call from HAL_SPI_TxCpltCallback
+#endif
+#if (WS28XX_MULTI_CHANNEL > 1)
+void WS28XX_PeriodElapsedCallback(WS28XX_HandleTypeDef *Handle, TIM_HandleTypeDef *HTim); //@info Call from HAL_TIM_PeriodElapsedCallback
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,293 @@
+#ifndef _WS28XX_HPP_
+#define _WS28XX_HPP_
+
+/***********************************************************************************************************
+
+  C++ front end of the WS28XX library, header only.
+
+  ws28xx::Strip wraps an initialized WS28XX_HandleTypeDef. Color order, gamma, channel count and the pixel
+  format of its setters are template parameters, so every strip gets its own setters with the order and the
+  gamma table resolved at compile time, and strips of different orders can share one binary. The pixels are
+  stored the way WS28XX_Update sends them, the encoder itself does not depend on the order.
+
+    WS28XX_HandleTypeDef hLed;
+    ws28xx::Strip<ws28xx::Order::GRB, 28> strip(hLed); //@info GRB with gamma 2.8
+    WS28XX_Init(&hLed, &htim1, 72, TIM_CHANNEL_1, 60);
+    strip.Set(0, 255, 128, 0);
+    strip.Update();
+
+  Drive a strip only through its ws28xx::Strip. The C setters, WS28XX_Post_* and WS28XX_SetColorCorrection
+  use WS28XX_ORDER and WS28XX_GAMMA of ws2812b_conf.h. The brightness functions and the color LUT of the C API
+  can be used, they work on the stored channels.
+
+***********************************************************************************************************/
+
+/************************************************************************************************************
+**************    Include Headers
+************************************************************************************************************/
+
+#include <array>
+#include <stdint.h>
+#include <type_traits>
+#include "ws2812b_conf.h"
+
+#if (__cplusplus < 201703L)
+#	error "ws28xx.hpp needs C++17"
+#endif
+
+#if (WS28XX_FRAMEBUFFER == true)
+#	error "ws28xx.hpp stores pixels in the handle, WS28XX_FRAMEBUFFER has none"
+#endif
+
+#if (WS28XX_PALETTE > 0)
+#	error "ws28xx.hpp stores colors in the pixels, WS28XX_PALETTE pixels are palette indexes"
+#endif
+
+#include "ws28xx.h"
+
+namespace ws28xx {
+
+/************************************************************************************************************
+**************    Public struct/enum
+************************************************************************************************************/
+
+enum class Order : uint8_t {
+	RGB = WS28XX_ORDER_RGB,
+	BGR = WS28XX_ORDER_BGR,
+	GRB = WS28XX_ORDER_GRB,
+};
+
+enum class Format : uint8_t {
+	RGB888   = WS28XX_FORMAT_888,  //@info uint32_t 0xRRGGBB, or 3 bytes per pixel red first
+	RGBW8888 = WS28XX_FORMAT_8888, //@info uint32_t 0xRRGGBBWW, or 4 bytes per pixel red first, white last
+	RGB565   = WS28XX_FORMAT_565,  //@info uint16_t RGB565
+};
+
+/************************************************************************************************************
+**************    Private Functions
+************************************************************************************************************/
+
+namespace detail {
+
+//@info Natural logarithm for X > 0, X is brought to 0.5..1 by powers of 2 so the atanh series converges fast
+constexpr double Log(double X) {
+	double exponent = 0;
+	while (X < 0.5) {
+		X *= 2;
+		exponent -= 1;
+	}
+	while (X >= 1) {
+		X /= 2;
+		exponent += 1;
+	}
+	double z    = (X - 1) / (X + 1);
+	double term = z;
+	double sum  = 0;
+	for (int n = 1; n < 40; n += 2) {
+		sum += term / n;
+		term *= z * z;
+	}
+	return (2 * sum) + (exponent * 0.69314718055994531);
+}
+
+/***********************************************************************************************************/
+
+//@info e^X for X <= 0, whole steps of 1 / e and a Taylor series for the rest
+constexpr double Exp(double X) {
+	double scale = 1;
+	while (X < -1) {
+		X += 1;
+		scale *= 0.36787944117144233;
+	}
+	double term = 1;
+	double sum  = 1;
+	for (int n = 1; n < 30; n++) {
+		term *= X / n;
+		sum += term;
+	}
+	return scale * sum;
+}
+
+/***********************************************************************************************************/
+
+//@info round(255 * (value / 255) ^ (Gamma / 10)), the table WS28XX_BuildColorLut builds at run time
+constexpr std::array<uint8_t, 256> GammaTable(uint8_t Gamma) {
+	std::array<uint8_t, 256> table {};
+	for (int value = 1; value < 256; value++) {
+		table[value] = (uint8_t)((255.0 * Exp((Gamma / 10.0) * Log(value / 255.0))) + 0.5);
+	}
+	return table;
+}
+
+/***********************************************************************************************************/
+
+//@info Channel of WS28XX_PixelTypeDef::Color that red, green and blue are sent in
+constexpr std::array<uint8_t, 3> OrderIndex(Order Order) {
+	switch (Order) {
+		case Order::BGR:
+			return {2, 1, 0};
+		case Order::GRB:
+			return {1, 0, 2};
+		default:
+			return {0, 1, 2};
+	}
+}
+
+} // namespace detail
+
+/************************************************************************************************************
+**************    Public Classes
+************************************************************************************************************/
+
+/**
+ * @brief  WS28XX strip with compile time color order, gamma and pixel format
+ *
+ * @param  O: Order the chips expect the colors in
+ * @param  Gamma: Gamma exponent in tenths, 28 is 2.8. 0 or 10 store the colors as they are
+ * @param  Channel: 3 for RGB, 4 for RGBW chips. Fixes the pixel layout, it must be WS28XX_COLOR_CHANNEL
+ * @param  F: Format of the packed colors of Set, Fill and Copy
+ */
+template <Order O, uint8_t Gamma = 0, uint8_t Channel = WS28XX_COLOR_CHANNEL, Format F = Format::RGB888>
+class Strip {
+	static_assert(Channel == WS28XX_COLOR_CHANNEL, "the handle holds and sends WS28XX_COLOR_CHANNEL channels per pixel");
+
+public:
+	using ColorType   = std::conditional_t<F == Format::RGB565, uint16_t, uint32_t>; //@info One packed color of Set and Fill
+	using ElementType = std::conditional_t<F == Format::RGB565, uint16_t, uint8_t>;  //@info Source of Copy
+	static constexpr uint8_t Stride = (F == Format::RGB565) ? 1 : ((F == Format::RGBW8888) ? 4 : 3); //@info Elements per pixel in Copy
+
+	WS28XX_HandleTypeDef &Handle;
+
+	explicit Strip(WS28XX_HandleTypeDef &Handle) : Handle(Handle) {}
+
+	/**
+	 * @brief  Set Pixel
+	 * @note   Like WS28XX_SetPixel_RGB_White with the order and gamma of the strip, the brightest channel is the
+	 *         brightness. White is dropped on RGB chips.
+	 *
+	 * @retval bool: true or false
+	 */
+	bool Set(uint16_t Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t White = 0) {
+		if (Pixel >= Handle.Num_Pixel) {
+			return false;
+		}
+		Store(Handle.Pixel[Pixel], Red, Green, Blue, White);
+		MarkDirty(Pixel, Pixel);
+		return true;
+	}
+
+	/**
+	 * @brief  Set Pixel
+	 * @note   Color is packed in the format of the strip
+	 *
+	 * @retval bool: true or false
+	 */
+	bool Set(uint16_t Pixel, ColorType Color) {
+		if (Pixel >= Handle.Num_Pixel) {
+			return false;
+		}
+		StoreColor(Handle.Pixel[Pixel], Color);
+		MarkDirty(Pixel, Pixel);
+		return true;
+	}
+
+	/**
+	 * @brief  Fill pixels
+	 * @note   Set Count pixels from First to one packed color, it is converted once
+	 *
+	 * @retval bool: true or false, nothing is written when the range does not fit the strip
+	 */
+	bool Fill(uint16_t First, uint16_t Count, ColorType Color) {
+		WS28XX_PixelTypeDef pixel;
+		if ((Count == 0) || (((uint32_t)First + Count) > Handle.Num_Pixel)) {
+			return false;
+		}
+		StoreColor(pixel, Color);
+		for (WS28XX_PixelTypeDef *px = &Handle.Pixel[First], *end = px + Count; px < end; px++) {
+			*px = pixel;
+		}
+		MarkDirty(First, First + Count - 1);
+		return true;
+	}
+
+	/**
+	 * @brief  Copy pixels
+	 * @note   Set Count pixels from First to an image row in the format of the strip, Stride elements per pixel
+	 *
+	 * @retval bool: true or false, nothing is written when the range does not fit the strip
+	 */
+	bool Copy(uint16_t First, uint16_t Count, const ElementType *Src) {
+		if ((Src == nullptr) || (Count == 0) || (((uint32_t)First + Count) > Handle.Num_Pixel)) {
+			return false;
+		}
+		for (WS28XX_PixelTypeDef *px = &Handle.Pixel[First], *end = px + Count; px < end; px++, Src += Stride) {
+			if constexpr (F == Format::RGB565) {
+				StoreColor(*px, *Src);
+			} else if constexpr (F == Format::RGBW8888) {
+				Store(*px, Src[0], Src[1], Src[2], Src[3]);
+			} else {
+				Store(*px, Src[0], Src[1], Src[2], 0);
+			}
+		}
+		MarkDirty(First, First + Count - 1);
+		return true;
+	}
+
+	bool Update() { return WS28XX_Update(&Handle); }
+
+	//@info Value a channel is stored with, gamma applied
+	static constexpr uint8_t Correct(uint8_t Value) {
+		if constexpr ((Gamma == 0) || (Gamma == 10)) {
+			return Value;
+		} else {
+			return Table[Value];
+		}
+	}
+
+private:
+	static constexpr std::array<uint8_t, 3>   Index = detail::OrderIndex(O);
+	static constexpr std::array<uint8_t, 256> Table = detail::GammaTable(Gamma);
+
+	//@info Store a color as WS28XX_Update sends it, the brightest raw channel as brightness
+	static void Store(WS28XX_PixelTypeDef &Pixel, uint8_t Red, uint8_t Green, uint8_t Blue, uint8_t White) {
+		uint8_t brightness = MAX_OF_THREE(Red, Green, Blue);
+		Pixel.Color[Index[0]] = Correct(Red);
+		Pixel.Color[Index[1]] = Correct(Green);
+		Pixel.Color[Index[2]] = Correct(Blue);
+		if constexpr (Channel == 4) {
+			brightness     = (White > brightness) ? White : brightness;
+			Pixel.Color[3] = Correct(White);
+		} else {
+			(void)White;
+		}
+		Pixel.Brightness = brightness;
+	}
+
+	/***********************************************************************************************************/
+
+	static void StoreColor(WS28XX_PixelTypeDef &Pixel, ColorType Color) {
+		if constexpr (F == Format::RGB565) {
+			Store(Pixel, (Color >> 8) & 0xF8, (Color >> 3) & 0xFC, (Color << 3) & 0xF8, 0);
+		} else if constexpr (F == Format::RGBW8888) {
+			Store(Pixel, (uint8_t)(Color >> 24), (uint8_t)(Color >> 16), (uint8_t)(Color >> 8), (uint8_t)Color);
+		} else {
+			Store(Pixel, (uint8_t)(Color >> 16), (uint8_t)(Color >> 8), (uint8_t)Color, 0);
+		}
+	}
+
+	/***********************************************************************************************************/
+
+	//@info Grow the dirty span of the handle so it covers First..Last, as the C setters do
+	void MarkDirty(uint16_t First, uint16_t Last) {
+		if (First < Handle.Dirty_First) {
+			Handle.Dirty_First = First;
+		}
+		if (Last > Handle.Dirty_Last) {
+			Handle.Dirty_Last = Last;
+		}
+	}
+};
+
+} // namespace ws28xx
+
+#endif /* _WS28XX_HPP_ */